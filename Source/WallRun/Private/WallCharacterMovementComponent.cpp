@@ -13,4 +13,27 @@ void UWallCharacterMovementComponent::Crouch(bool bClientSimulation)
 void UWallCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 {
 	//Super::UnCrouch(bClientSimulation);
-}
\ No newline at end of file
+}
+bool UWallCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	// server has already performed the move, compare where both ended
+	if (UpdatedComponent)
+	{
+		const float Error = FVector::Dist(UpdatedComponent->GetComponentLocation(), ClientWorldLocation);
+		++NetStats.NumMoves;
+		NetStats.ErrorSum += Error;
+		NetStats.MaxError = FMath::Max(NetStats.MaxError, Error);
+	}
+	return Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+void UWallCharacterMovementComponent::SendClientAdjustment()
+{
+	// pending adjustment that is not an ack of good move is a correction
+	const FNetworkPredictionData_Server_Character* ServerData = HasPredictionData_Server() ? GetPredictionData_Server_Character() : nullptr;
+	if (ServerData && ServerData->PendingAdjustment.TimeStamp > 0.f && !ServerData->PendingAdjustment.bAckGoodMove)
+	{
+		++NetStats.NumCorrections;
+	}
+	Super::SendClientAdjustment();
+}
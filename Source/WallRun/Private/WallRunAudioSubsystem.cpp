@@ -0,0 +1,261 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunAudioSubsystem.h"
+#include "WallRun.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundConcurrency.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+
+
+void UWallRunAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+}
+
+USoundConcurrency* UWallRunAudioSubsystem::GetOneShotConcurrency(USoundBase* Sound)
+{
+	// one concurrency object is one group, so every sound gets its own: other players' gunfire doesn't cut the jump sound.
+	// oldest instance is stopped when limit reached
+	USoundConcurrency*& Concurrency = OneShotConcurrency.FindOrAdd(Sound);
+	if (!Concurrency)
+	{
+		LLM_SCOPE_BYTAG(WallRun_Audio);
+		Concurrency = NewObject<USoundConcurrency>(this);
+		Concurrency->Concurrency.MaxCount = MaxOneShotVoices;
+		Concurrency->Concurrency.bLimitToOwner = false;
+		Concurrency->Concurrency.ResolutionRule = EMaxConcurrentResolutionRule::StopOldest;
+	}
+	return Concurrency;
+}
+
+void UWallRunAudioSubsystem::Deinitialize()
+{
+	for (UAudioComponent* Voice : Voices)
+	{
+		if (Voice)
+		{
+			Voice->Stop();
+			Voice->DestroyComponent();
+		}
+	}
+	Loops.Empty();
+	FreeVoices.Empty();
+	Voices.Empty();
+	OneShotConcurrency.Empty();
+	Super::Deinitialize();
+}
+
+bool UWallRunAudioSubsystem::IsAudible(const FVector& Location, float& OutDistSquared) const
+{
+	OutDistSquared = BIG_NUMBER;
+	UWorld* World = GetWorld();
+	// no one to hear on dedicated server
+	if (!World || World->GetNetMode() == NM_DedicatedServer || !World->GetAudioDeviceRaw())
+	{
+		return false;
+	}
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ListenerLocation, FrontDir, RightDir;
+			PC->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+			OutDistSquared = FMath::Min(OutDistSquared, FVector::DistSquared(ListenerLocation, Location));
+		}
+	}
+	return OutDistSquared <= FMath::Square(MaxAudibleDistance);
+}
+
+UAudioComponent* UWallRunAudioSubsystem::CreateVoice()
+{
+	LLM_SCOPE_BYTAG(WallRun_Audio);
+	UAudioComponent* Voice = NewObject<UAudioComponent>(GetWorld());
+	Voice->bAutoActivate = false;
+	Voice->bAutoDestroy = false;
+	Voice->RegisterComponentWithWorld(GetWorld());
+	Voices.Add(Voice);
+	return Voice;
+}
+
+void UWallRunAudioSubsystem::ReleaseVoice(UAudioComponent* Voice)
+{
+	Voice->Stop();
+	Voice->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	Voice->SetSound(nullptr);
+	FreeVoices.Add(Voice);
+}
+
+UAudioComponent* UWallRunAudioSubsystem::AcquireVoice(float DistSquared)
+{
+	if (FreeVoices.Num() > 0)
+	{
+		return FreeVoices.Pop(false);
+	}
+	if (Voices.Num() < MaxLoopVoices)
+	{
+		return CreateVoice();
+	}
+
+	// all voices busy - take the one furthest from listener if it's further than new one
+	FWallRunLoopRequest* Furthest = nullptr;
+	float FurthestDistSquared = DistSquared;
+	for (auto& Pair : Loops)
+	{
+		if (Pair.Value.Voice)
+		{
+			float OtherDistSquared;
+			IsAudible(Pair.Value.Voice->GetComponentLocation(), OtherDistSquared);
+			if (OtherDistSquared > FurthestDistSquared)
+			{
+				FurthestDistSquared = OtherDistSquared;
+				Furthest = &Pair.Value;
+			}
+		}
+	}
+	if (!Furthest)
+	{
+		return nullptr;
+	}
+	UAudioComponent* Voice = Furthest->Voice;
+	Furthest->Voice = nullptr;
+	Voice->Stop();
+	return Voice;
+}
+
+void UWallRunAudioSubsystem::StartVoice(FWallRunLoopRequest& Request, UAudioComponent* Voice)
+{
+	Voice->AttachToComponent(Request.AttachTo.Get(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	Voice->SetSound(Request.Sound.Get());
+	Voice->Play();
+	Request.Voice = Voice;
+}
+
+bool UWallRunAudioSubsystem::PlayLoop(const UObject* Owner, USoundBase* Sound, USceneComponent* AttachTo)
+{
+	if (!Owner || !Sound || !AttachTo)
+	{
+		return false;
+	}
+	StopLoop(Owner);
+
+	// no one to hear on dedicated server, don't even keep the request
+	UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	FWallRunLoopRequest& Request = Loops.Add(Owner);
+	Request.Sound = Sound;
+	Request.AttachTo = AttachTo;
+
+	float DistSquared;
+	if (!IsAudible(AttachTo->GetComponentLocation(), DistSquared))
+	{
+		return false;
+	}
+	UAudioComponent* Voice = AcquireVoice(DistSquared);
+	if (!Voice)
+	{
+		return false;
+	}
+	StartVoice(Request, Voice);
+	return true;
+}
+
+void UWallRunAudioSubsystem::StopLoop(const UObject* Owner)
+{
+	FWallRunLoopRequest Request;
+	if (Loops.RemoveAndCopyValue(Owner, Request) && Request.Voice)
+	{
+		ReleaseVoice(Request.Voice);
+	}
+}
+
+void UWallRunAudioSubsystem::UpdateLoops()
+{
+	struct FCandidate
+	{
+		FWallRunLoopRequest* Request;
+		float DistSquared;
+	};
+	TArray<FCandidate, TInlineAllocator<32>> Audible;
+
+	for (auto It = Loops.CreateIterator(); It; ++It)
+	{
+		FWallRunLoopRequest& Request = It.Value();
+		USceneComponent* AttachTo = Request.AttachTo.Get();
+		float DistSquared;
+		if (!AttachTo || !Request.Sound.IsValid())
+		{
+			// owner went away without stopping
+			if (Request.Voice)
+			{
+				ReleaseVoice(Request.Voice);
+			}
+			It.RemoveCurrent();
+		}
+		else if (IsAudible(AttachTo->GetComponentLocation(), DistSquared))
+		{
+			Audible.Add({ &Request, DistSquared });
+		}
+		else if (Request.Voice)
+		{
+			ReleaseVoice(Request.Voice);
+			Request.Voice = nullptr;
+		}
+	}
+
+	// closest MaxLoopVoices loops are heard, voices of the rest go to them
+	Audible.Sort([](const FCandidate& A, const FCandidate& B) { return A.DistSquared < B.DistSquared; });
+	for (int32 Index = MaxLoopVoices; Index < Audible.Num(); ++Index)
+	{
+		if (Audible[Index].Request->Voice)
+		{
+			ReleaseVoice(Audible[Index].Request->Voice);
+			Audible[Index].Request->Voice = nullptr;
+		}
+	}
+	for (int32 Index = 0; Index < FMath::Min(MaxLoopVoices, Audible.Num()); ++Index)
+	{
+		FWallRunLoopRequest& Request = *Audible[Index].Request;
+		if (!Request.Voice)
+		{
+			if (UAudioComponent* Voice = AcquireVoice(Audible[Index].DistSquared))
+			{
+				StartVoice(Request, Voice);
+			}
+		}
+	}
+}
+
+void UWallRunAudioSubsystem::PlaySound2D(const UObject* WorldContextObject, USoundBase* Sound)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	UWallRunAudioSubsystem* AudioSubsystem = World ? World->GetSubsystem<UWallRunAudioSubsystem>() : nullptr;
+	if (!Sound || !AudioSubsystem)
+	{
+		return;
+	}
+	UGameplayStatics::PlaySound2D(WorldContextObject, Sound, 1.f, 1.f, 0.f, AudioSubsystem->GetOneShotConcurrency(Sound));
+}
+
+void UWallRunAudioSubsystem::PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, FVector Location)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	UWallRunAudioSubsystem* AudioSubsystem = World ? World->GetSubsystem<UWallRunAudioSubsystem>() : nullptr;
+	float DistSquared;
+	if (!Sound || !AudioSubsystem || !AudioSubsystem->IsAudible(Location, DistSquared))
+	{
+		return;
+	}
+	UGameplayStatics::PlaySoundAtLocation(WorldContextObject, Sound, Location, FRotator::ZeroRotator, 1.f, 1.f, 0.f, nullptr, AudioSubsystem->GetOneShotConcurrency(Sound));
+}
@@ -0,0 +1,280 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunCollisionAuditCommandlet.h"
+#include "WallRunComponent.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "StaticMeshResources.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunCollisionAudit, Log, All);
+
+
+UWallRunCollisionAuditCommandlet::UWallRunCollisionAuditCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+float UWallRunCollisionAuditCommandlet::EstimateQueryCost(const FMeshAudit& Audit)
+{
+	// rough model: simple shape test = 1, complex = BVH walk (log2) plus a few triangle tests per leaf
+	if (Audit.bComplexAsSimple || Audit.NumSimplePrimitives == 0)
+	{
+		return 4.f + FMath::Log2((float)FMath::Max(Audit.NumTriangles, 1)) * 2.f;
+	}
+	return (float)Audit.NumSimplePrimitives;
+}
+
+bool UWallRunCollisionAuditCommandlet::SimplifyCollision(UStaticMesh* Mesh, bool bConvex)
+{
+#if WITH_EDITOR
+	UBodySetup* BodySetup = Mesh->GetBodySetup();
+	FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+	if (!BodySetup || !RenderData || RenderData->LODResources.Num() == 0)
+	{
+		return false;
+	}
+
+	BodySetup->Modify();
+	BodySetup->RemoveSimpleCollision();
+	BodySetup->CollisionTraceFlag = CTF_UseDefault;
+
+	const FBox Bounds = Mesh->GetBoundingBox();
+	if (!bConvex)
+	{
+		FKBoxElem Box(Bounds.GetSize().X, Bounds.GetSize().Y, Bounds.GetSize().Z);
+		Box.Center = Bounds.GetCenter();
+		BodySetup->AggGeom.BoxElems.Add(Box);
+	}
+	else
+	{
+		// extreme vertices along 26 directions (axes, edges and corners of a cube) - cheap convex close to the mesh shape
+		const FPositionVertexBuffer& Positions = RenderData->LODResources[0].VertexBuffers.PositionVertexBuffer;
+		TArray<FVector> Extremes;
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			for (int32 Y = -1; Y <= 1; ++Y)
+			{
+				for (int32 Z = -1; Z <= 1; ++Z)
+				{
+					if (X == 0 && Y == 0 && Z == 0)
+					{
+						continue;
+					}
+					const FVector Direction(X, Y, Z);
+					FVector Best = Bounds.GetCenter();
+					float BestDot = -BIG_NUMBER;
+					for (uint32 i = 0; i < Positions.GetNumVertices(); ++i)
+					{
+						const FVector Position = Positions.VertexPosition(i);
+						const float Dot = FVector::DotProduct(Position, Direction);
+						if (Dot > BestDot)
+						{
+							BestDot = Dot;
+							Best = Position;
+						}
+					}
+					Extremes.AddUnique(Best);
+				}
+			}
+		}
+		FKConvexElem Convex;
+		Convex.VertexData = Extremes;
+		Convex.UpdateElemBox();
+		BodySetup->AggGeom.ConvexElems.Add(Convex);
+	}
+
+	BodySetup->InvalidatePhysicsData();
+	BodySetup->CreatePhysicsMeshes();
+	Mesh->MarkPackageDirty();
+	return true;
+#else
+	return false;
+#endif
+}
+
+int32 UWallRunCollisionAuditCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens, Switches;
+	TMap<FString, FString> ParamMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamMap);
+
+	// object types to audit: explicit list or ObjectTypesForWallRun of the pawn's wallrun component
+	TArray<ECollisionChannel> ObjectTypes;
+	if (const FString* TypesParam = ParamMap.Find(TEXT("ObjectTypes")))
+	{
+		TArray<FString> TypeNames;
+		TypesParam->ParseIntoArray(TypeNames, TEXT("+"));
+		const UEnum* ChannelEnum = StaticEnum<ECollisionChannel>();
+		for (const FString& TypeName : TypeNames)
+		{
+			const int64 Value = ChannelEnum->GetValueByNameString(FString(TEXT("ECC_")) + TypeName);
+			if (Value != INDEX_NONE)
+			{
+				ObjectTypes.Add((ECollisionChannel)Value);
+			}
+		}
+	}
+	else
+	{
+		const FString PawnPath = ParamMap.FindRef(TEXT("Pawn")).IsEmpty() ? TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter") : ParamMap.FindRef(TEXT("Pawn"));
+		const FString PawnClassPath = PawnPath + TEXT(".") + FPackageName::GetShortName(PawnPath) + TEXT("_C");
+		if (UClass* PawnClass = LoadObject<UClass>(nullptr, *PawnClassPath))
+		{
+			AActor* PawnDefaults = PawnClass->GetDefaultObject<AActor>();
+			if (UWallRunComponent* WallRunComp = PawnDefaults ? PawnDefaults->FindComponentByClass<UWallRunComponent>() : nullptr)
+			{
+				for (const TEnumAsByte<ECollisionChannel>& Type : WallRunComp->ObjectTypesForWallRun)
+				{
+					ObjectTypes.Add(Type.GetValue());
+				}
+			}
+		}
+	}
+	if (ObjectTypes.Num() == 0)
+	{
+		UE_LOG(LogWallRunCollisionAudit, Error, TEXT("No object types to audit, use -ObjectTypes= or -Pawn="));
+		return 1;
+	}
+
+	// maps to scan: explicit list or every map in project
+	TArray<FString> MapPackages;
+	if (const FString* MapsParam = ParamMap.Find(TEXT("Maps")))
+	{
+		MapsParam->ParseIntoArray(MapPackages, TEXT("+"));
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+		TArray<FAssetData> MapAssets;
+		AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetFName(), MapAssets);
+		for (const FAssetData& MapAsset : MapAssets)
+		{
+			if (MapAsset.PackageName.ToString().StartsWith(TEXT("/Game/")))
+			{
+				MapPackages.Add(MapAsset.PackageName.ToString());
+			}
+		}
+	}
+
+	TMap<UStaticMesh*, FMeshAudit> Audits;
+	for (const FString& MapPackage : MapPackages)
+	{
+		UPackage* Package = LoadPackage(nullptr, *MapPackage, LOAD_None);
+		UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogWallRunCollisionAudit, Warning, TEXT("Failed to load map %s"), *MapPackage);
+			continue;
+		}
+		UE_LOG(LogWallRunCollisionAudit, Display, TEXT("Scanning %s"), *MapPackage);
+
+		for (ULevel* Level : World->GetLevels())
+		{
+			if (!Level)
+			{
+				continue;
+			}
+			for (AActor* Actor : Level->Actors)
+			{
+				if (!Actor)
+				{
+					continue;
+				}
+				TInlineComponentArray<UStaticMeshComponent*> MeshComponents(Actor);
+				for (UStaticMeshComponent* MeshComp : MeshComponents)
+				{
+					UStaticMesh* Mesh = MeshComp->GetStaticMesh();
+					if (!Mesh || !ObjectTypes.Contains(MeshComp->GetCollisionObjectType()) || MeshComp->GetCollisionEnabled() == ECollisionEnabled::NoCollision)
+					{
+						continue;
+					}
+					FMeshAudit& Audit = Audits.FindOrAdd(Mesh);
+					if (Audit.NumComponents == 0)
+					{
+						const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+						Audit.NumTriangles = (RenderData && RenderData->LODResources.Num() > 0) ? RenderData->LODResources[0].GetNumTriangles() : 0;
+						if (const UBodySetup* BodySetup = Mesh->GetBodySetup())
+						{
+							Audit.NumSimplePrimitives = BodySetup->AggGeom.GetElementCount();
+							Audit.bComplexAsSimple = BodySetup->CollisionTraceFlag == CTF_UseComplexAsSimple;
+						}
+					}
+					++Audit.NumComponents;
+				}
+			}
+		}
+	}
+
+	// -Fix only touches meshes using complex collision for queries. meshes with many simple primitives are
+	// reported, their collision is usually authored (arches, doorways) and one box or hull would ruin it,
+	// they are replaced only with -SimplifyAuthored
+	const FString FixMode = ParamMap.FindRef(TEXT("Fix"));
+	const bool bFix = FixMode == TEXT("Box") || FixMode == TEXT("Convex");
+	const bool bSimplifyAuthored = Switches.Contains(TEXT("SimplifyAuthored"));
+
+	FString Report = TEXT("Mesh,Components,Triangles,SimplePrimitives,ComplexAsSimple,CostBefore,CostAfter,Fixed\n");
+	float TotalCostBefore = 0.f;
+	float TotalCostAfter = 0.f;
+	for (auto& Pair : Audits)
+	{
+		UStaticMesh* Mesh = Pair.Key;
+		const FMeshAudit& Audit = Pair.Value;
+		const float CostBefore = EstimateQueryCost(Audit);
+		float CostAfter = CostBefore;
+		bool bFixed = false;
+
+		const bool bUsesComplex = Audit.bComplexAsSimple || Audit.NumSimplePrimitives == 0;
+		const bool bManyPrimitives = Audit.NumSimplePrimitives > 4;
+		if (bUsesComplex || bManyPrimitives)
+		{
+			FMeshAudit Simplified = Audit;
+			Simplified.bComplexAsSimple = false;
+			Simplified.NumSimplePrimitives = 1;
+			CostAfter = EstimateQueryCost(Simplified);
+			if (bFix && (bUsesComplex || bSimplifyAuthored))
+			{
+				bFixed = SimplifyCollision(Mesh, FixMode == TEXT("Convex"));
+			}
+		}
+
+		TotalCostBefore += CostBefore * Audit.NumComponents;
+		TotalCostAfter += CostAfter * Audit.NumComponents;
+		Report += FString::Printf(TEXT("%s,%d,%d,%d,%d,%.1f,%.1f,%d\n"), *Mesh->GetPathName(), Audit.NumComponents, Audit.NumTriangles,
+			Audit.NumSimplePrimitives, Audit.bComplexAsSimple ? 1 : 0, CostBefore, CostAfter, bFixed ? 1 : 0);
+
+#if WITH_EDITOR
+		if (bFixed)
+		{
+			UPackage* MeshPackage = Mesh->GetOutermost();
+			const FString Filename = FPackageName::LongPackageNameToFilename(MeshPackage->GetName(), FPackageName::GetAssetPackageExtension());
+			if (!UPackage::SavePackage(MeshPackage, Mesh, RF_Public | RF_Standalone, *Filename))
+			{
+				UE_LOG(LogWallRunCollisionAudit, Error, TEXT("Failed to save %s"), *Filename);
+			}
+		}
+#endif
+	}
+
+	const FString ReportPath = ParamMap.FindRef(TEXT("Report")).IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("WallRun/CollisionAudit.csv") : ParamMap.FindRef(TEXT("Report"));
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+	UE_LOG(LogWallRunCollisionAudit, Display, TEXT("%d meshes in %d maps, estimated query cost %.0f -> %.0f (%.0f%% reduction), report: %s"),
+		Audits.Num(), MapPackages.Num(), TotalCostBefore, TotalCostAfter,
+		TotalCostBefore > 0.f ? (1.f - TotalCostAfter / TotalCostBefore) * 100.f : 0.f, *ReportPath);
+	return 0;
+}
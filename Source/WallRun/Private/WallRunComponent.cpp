@@ -2,17 +2,54 @@
 
 
 #include "WallRunComponent.h"
+#include "WallRun.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
 #include "DrawDebugHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Components/AudioComponent.h"
+#include "WallRunAudioSubsystem.h"
+#include "WallRunEventBus.h"
+#include "WallRunFeatures.h"
+#include "WallRunLedgeClimb.h"
+#include "WallRunPerfCounters.h"
+#include "WallRunTrace.h"
 #include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Sound/SoundBase.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunComponent, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("WallRun Tick"), STAT_WallRunTick, STATGROUP_WallRun);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predictive Wall Sticks"), STAT_WallRunPredictiveSticks, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffered Inputs"), STAT_WallRunBufferedInputs, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffered Input Hits"), STAT_WallRunBufferedInputHits, STATGROUP_WallRun);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Buffered Input Hit Rate"), STAT_WallRunBufferedInputHitRate, STATGROUP_WallRun);
+
+// totals over all components for hit rate stat
+static uint32 GWallRunBufferedInputs = 0;
+static uint32 GWallRunBufferedInputHits = 0;
+
+// log of state changes when DebugLog is on and policy has debug log, nothing is compiled otherwise
+#if WALLRUN_WITH_DEBUG_LOG
+#define WALLRUN_DEBUG_LOG(Policy, Format, ...) do { if (Policy::bDebugLog && DebugLog) { UE_LOG(LogWallRunComponent, Log, Format, ##__VA_ARGS__); } } while (0)
+#else
+#define WALLRUN_DEBUG_LOG(Policy, Format, ...) do {} while (0)
+#endif
+
+static void UpdateBufferedInputHitRateStat()
+{
+	SET_FLOAT_STAT(STAT_WallRunBufferedInputHitRate, (float)GWallRunBufferedInputHits / (float)FMath::Max(GWallRunBufferedInputs, 1u));
+}
 
 
 // Sets default values for this component's properties
 UWallRunComponent::UWallRunComponent()
 {
+	LLM_SCOPE_BYTAG(WallRun_Components);
+
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
@@ -21,6 +58,8 @@ UWallRunComponent::UWallRunComponent()
 	bOnFloor = true;
 	bCanJumpFromWall = false;
 	bClimbingLedge = false;
+	bClimbFailRecorded = false;
+	CharacterId = 0;
 	WallRunDuration = 3.0f;
 	LaunchStrengthNormal = 150.f;
 	LaunchStrengthLook = 400.f;
@@ -33,11 +72,31 @@ UWallRunComponent::UWallRunComponent()
 	LaunchOnStickSide = 500.f;
 	MovementumAdjust = 0.1f;
 	ClimbStrength = 100.f;
+	bNativeLedgeClimb = true;
+	ClimbDuration = 0.4f;
+	ClimbRiseFraction = 0.6f;
+	LedgeForwardDistance = 30.f;
+	MaxLedgeHeight = 120.f;
 	AllowedDeviationFromWall = 0.35f;
 	DebugLog = false;
-	
-	AudioRunComp = CreateDefaultSubobject<UAudioComponent>("AudioComp");
-	
+	bLeanFeatures = false;
+	InputBufferTime = 0.15f;
+	PredictionTolerance = 10.f;
+	WallTraceLength = 100.f;
+	SameWallAngle = 30.f;
+	WallNormalInterpSpeed = 15.f;
+	WallLostGraceTime = 0.05f;
+	WallLostTime = 0.f;
+	WallTraceInterval = 0.f;
+	TimeSinceWallTrace = 0.f;
+	bPredictiveWallAcquisition = false;
+	AcquisitionInterval = 0.f;
+	TimeSinceAcquisition = 0.f;
+	bAudioEnabled = true;
+	BufferedJumpTime = -1.f;
+	BufferedDetachTime = -1.f;
+	NumBufferedInputs = 0;
+	NumBufferedInputHits = 0;
 }
 
 
@@ -45,11 +104,10 @@ UWallRunComponent::UWallRunComponent()
 void UWallRunComponent::BeginPlay()
 {
 	Super::BeginPlay();
-	// set sound indication duration of wallrun
-	if (WallRunSound)
-	{
-		AudioRunComp->SetSound(WallRunSound);
-	}
+
+	// game thread only
+	static uint32 NextCharacterId = 0;
+	CharacterId = ++NextCharacterId;
 
 	CompOwner = Cast<ACharacter>(GetOwner());
 	if (CompOwner)
@@ -58,6 +116,9 @@ void UWallRunComponent::BeginPlay()
 		if (MoveComp)
 		{
 			CompOwner->OnActorHit.AddDynamic(this, &UWallRunComponent::OnHit);
+			// predictive acquisition moves the capsule with SafeMoveUpdatedComponent, has to run after this frame's movement
+			// update, otherwise movement tick would integrate velocity from the pre-stick position
+			AddTickPrerequisiteComponent(MoveComp);
 			DefaultGravity = MoveComp->GravityScale;
 			DefaultAirControl = MoveComp->AirControl;
 			WallDirection = FVector::ZeroVector;
@@ -65,53 +126,107 @@ void UWallRunComponent::BeginPlay()
 	}	
 }
 
+void UWallRunComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// give wallrun sound voice back to the pool
+	if (FWallRunDefaultPolicy::bAudio && !WallRunSound.IsNull())
+	{
+		if (UWallRunAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UWallRunAudioSubsystem>())
+		{
+			AudioSubsystem->StopLoop(this);
+		}
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 
 void UWallRunComponent::OnHit_Implementation(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit)
 {
+	if (bLeanFeatures)
+	{
+		HandleHit<FWallRunLeanPolicy>(Hit);
+	}
+	else
+	{
+		HandleHit<FWallRunDefaultPolicy>(Hit);
+	}
+}
+
+template <typename TPolicy>
+void UWallRunComponent::HandleHit(const FHitResult& Hit)
+{
+	WALLRUN_PERF_COUNT(NumHits);
 	float Verticality = FMath::RoundHalfFromZero(Hit.Normal.Z); // 0 for wall, 1 for floor
 
 	// check if player collided with wall
-	if (ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) && MoveComp->IsFalling() && Verticality == 0.f && bOnWall == false)
+	if (ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) && MoveComp->IsFalling() && Verticality == 0.f && bOnWall == false && bClimbingLedge == false)
 	{
-		if (DebugLog)
-			UE_LOG(LogTemp, Log, TEXT("Wall Hit"));
+		WALLRUN_DEBUG_LOG(TPolicy, TEXT("Wall Hit"));
 		// detect if it's the same wall to not stick to it
 		FVector NewWallDirection = FVector::CrossProduct(FVector::UpVector, Hit.Normal);
-		if (NewWallDirection != WallDirection)
+		if (!IsSameWall(Hit.Normal))
 		{
-			WallNormal = Hit.Normal;
-			StickToWall();
+			// crouch pressed just before touching the wall means player doesn't want to wallrun
+			if (ConsumeBufferedInput(BufferedDetachTime))
+			{
+				WALLRUN_DEBUG_LOG(TPolicy, TEXT("Buffered crouch, skip wall"));
+				WallDirection = NewWallDirection;
+			}
+			else
+			{
+				WallNormal = Hit.Normal;
+				StickToWallImpl<TPolicy>();
+			}
 		}		
 	}
 
 	// check if ledge in front and climb it
-	if (ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) && MoveComp->IsFalling() && Verticality == 0.f && bOnWall == true && bClimbingLedge == false)
+	if (TPolicy::bLedgeClimb && ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) && MoveComp->IsFalling() && Verticality == 0.f && bOnWall == true && bClimbingLedge == false)
 	{
 		// @todo change way to detect ledge to L-like trace
 		FHitResult LedgeHit;
 		FVector Start = CompOwner->GetActorLocation() + FVector(0.f, 0.f, 50.f);
 		FVector End = Start + (-WallNormal) * 100.f;
 		GetWorld()->LineTraceSingleByChannel(LedgeHit, Start, End, ECC_Visibility);
-		if (LedgeHit.bBlockingHit == false && IsCharacterLookingAtWall())
+		WALLRUN_PERF_COUNT(NumTraces);
+		FVector ClimbTarget;
+		const bool bFacingLedge = LedgeHit.bBlockingHit == false && IsCharacterLookingAtWall();
+		if (bFacingLedge && (!bNativeLedgeClimb || FindLedgeTop(ClimbTarget)))
 		{
-			if (DebugLog)
-				UE_LOG(LogTemp, Log, TEXT("Climb ledge"));
+			WALLRUN_DEBUG_LOG(TPolicy, TEXT("Climb ledge"));
 			bClimbingLedge = true;
-			OffWall();
-			ClimbEvent.Broadcast(Hit.ImpactPoint);
+			OffWallImpl<TPolicy>(EWallRunOffWallReason::Climb);
+			if (bNativeLedgeClimb)
+			{
+				StartLedgeClimb(ClimbTarget);
+			}
+			// still broadcast for camera and animation
+			PushEventImpl<TPolicy>(EWallRunEventType::Climb, Hit.ImpactPoint, EWallRunOffWallReason::Other);
+		}
+		else if (bFacingLedge && !bClimbFailRecorded)
+		{
+			// player tries to climb but there is no room on top, wall hits repeat every frame so it's recorded once per wallrun
+			WALLRUN_DEBUG_LOG(TPolicy, TEXT("Climb ledge failed"));
+			bClimbFailRecorded = true;
+			PushEventImpl<TPolicy>(EWallRunEventType::ClimbFail, Hit.ImpactPoint, EWallRunOffWallReason::Other);
 		}
 	}
 
 	//check if player collided with floor
 	if (ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) && Verticality == 1.f && bOnFloor == false || !MoveComp->IsFalling())
 	{
-		if (DebugLog)
-			UE_LOG(LogTemp, Log, TEXT("Floor Hit"));
+		WALLRUN_DEBUG_LOG(TPolicy, TEXT("Floor Hit"));
+		if (!bOnFloor)
+		{
+			PushEventImpl<TPolicy>(EWallRunEventType::Land, FVector::ZeroVector, EWallRunOffWallReason::Other);
+		}
 		bOnFloor = true;
 		bClimbingLedge = false;
+		BufferedJumpTime = -1.f;
+		BufferedDetachTime = -1.f;
 		if (bOnWall)
 		{
-			OffWall();
+			OffWallImpl<TPolicy>(EWallRunOffWallReason::Land);
 		}	
 		WallDirection = FVector::ZeroVector;
 	}
@@ -121,80 +236,143 @@ void UWallRunComponent::OnHit_Implementation(AActor* SelfActor, AActor* OtherAct
 
 void UWallRunComponent::StickToWall()
 {
-	if (DebugLog)
-		UE_LOG(LogTemp, Log, TEXT("Stick to wall"));
+	if (bLeanFeatures)
+	{
+		StickToWallImpl<FWallRunLeanPolicy>();
+	}
+	else
+	{
+		StickToWallImpl<FWallRunDefaultPolicy>();
+	}
+}
+
+template <typename TPolicy>
+void UWallRunComponent::StickToWallImpl()
+{
+	WALLRUN_DEBUG_LOG(TPolicy, TEXT("Stick to wall"));
+	WALLRUN_PERF_COUNT(NumSticks);
 	bOnWall = true;
 	bCanJumpFromWall = true;
 	bOnFloor = false;
 	bClimbingLedge = false;
+	bClimbFailRecorded = false;
+	WallLostTime = 0.f;
+	TimeSinceWallTrace = 0.f;
 	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_WallRun);
-	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_CoyoteTime);
+	if (TPolicy::bCoyoteTime)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_CoyoteTime);
+	}
 
 	// timer to stop wallrunning after set time (to not infinitely run on one wall)
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_WallRun, this, &UWallRunComponent::OffWall, WallRunDuration, false);
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle_WallRun, this, &UWallRunComponent::WallRunTimeout, WallRunDuration, false);
 	MoveComp->GravityScale = OnWallGravity;
 	MoveComp->AirControl = OnWallAirControl;
 
 	// calculate wall direction
 	WallDirection = FVector::CrossProduct(FVector::UpVector, WallNormal);
 
-	// calculate whether wall on the right side (1) or on the left side (-1) of character
-	const float WallSide = CalculateWallSide();
-	//LastWallSide = WallSide;
-	
-	const FVector WallDirectionSide = WallDirection * WallSide; // make WallDirection point to the same direction as player
-
-	// calculate how much (strong) player is trying to move into the wall 
-	const FVector DirectionalStrength = MoveComp->GetLastInputVector();
-	float StrengthOfSideLaunch = FVector::DotProduct(WallDirection, DirectionalStrength);
-	StrengthOfSideLaunch = FMath::Abs(StrengthOfSideLaunch);
-
-	// dont launch player along the wall if he touches wall moving backwards
-	if (IsCharacterMovingBackwards())
-	{
-		StrengthOfSideLaunch = StrengthOfSideLaunch * 0.2;
-	}
-
 	// give movement impulse to player along the wall in the direction of velocity and slightly up
-	FVector Velocity = MoveComp->Velocity;
-	float MovementImpulse = Velocity.Size();
-	Velocity.Normalize();
-	Velocity.Z = 0.f;
-	// LaunchVelocity = (strength up) + (Strength in direction of look along the wall) + (Strength of momentum) + (impulse into wall)
-	FVector LaunchVelocity = (FVector::UpVector * LaunchOnStickUp) + (WallDirectionSide * LaunchOnStickSide * StrengthOfSideLaunch) + 
-								(Velocity * MovementImpulse * MovementumAdjust) + (-WallNormal * 100.f);
+	const FVector LaunchVelocity = CalculateStickLaunchVelocity(WallNormal, GetKinematics(), MoveComp->GetLastInputVector());
 	CompOwner->LaunchCharacter(LaunchVelocity, true, true);
 	
-	// play sound of wallrunning
-	if (WallRunSound && AudioRunComp != nullptr)
+	// play sound of wallrunning (only if it's loaded and someone can hear it)
+	if (TPolicy::bAudio && WallRunSound && bAudioEnabled)
 	{
-		AudioRunComp->Play();
+		if (UWallRunAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UWallRunAudioSubsystem>())
+		{
+			AudioSubsystem->PlayLoop(this, WallRunSound.Get(), CompOwner->GetRootComponent());
+		}
 	}	
 	// in blueprint: if no mouse input make camera look forward along the wall
-	OnWallEvent.Broadcast(WallNormal);
+	PushEventImpl<TPolicy>(EWallRunEventType::Stick, WallNormal, EWallRunOffWallReason::Other);
 	
 }
 
 
 
-void UWallRunComponent::OffWall()
+void UWallRunComponent::WallRunTimeout()
+{
+	OffWall(EWallRunOffWallReason::Timeout);
+}
+
+void UWallRunComponent::OffWall(EWallRunOffWallReason Reason)
+{
+	if (bLeanFeatures)
+	{
+		OffWallImpl<FWallRunLeanPolicy>(Reason);
+	}
+	else
+	{
+		OffWallImpl<FWallRunDefaultPolicy>(Reason);
+	}
+}
+
+template <typename TPolicy>
+void UWallRunComponent::OffWallImpl(EWallRunOffWallReason Reason)
 {
-	if (DebugLog)
-		UE_LOG(LogTemp, Log, TEXT("Unstick form wall"));
-	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_CoyoteTime);
+	WALLRUN_DEBUG_LOG(TPolicy, TEXT("Unstick form wall"));
+	if (TPolicy::bCoyoteTime)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_CoyoteTime);
+	}
 	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_WallRun);
+	WALLRUN_PERF_COUNT(NumUnsticks);
 	bOnWall = false;	
 	MoveComp->GravityScale = DefaultGravity;
 	MoveComp->AirControl = DefaultAirControl;
 	LastWallSide = 0.f;
-	OffWallEvent.Broadcast();
+	PushEventImpl<TPolicy>(EWallRunEventType::Unstick, WallNormal, Reason);
 
 	// coyote time for jump from wall
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle_CoyoteTime, this, &UWallRunComponent::CoyoteTime_Elapsed, CoyoteTime, false);
-	if (WallRunSound && AudioRunComp != nullptr)
+	if (TPolicy::bCoyoteTime)
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_CoyoteTime, this, &UWallRunComponent::CoyoteTime_Elapsed, CoyoteTime, false);
+	}
+	else
+	{
+		bCanJumpFromWall = false;
+	}
+	if (TPolicy::bAudio && !WallRunSound.IsNull())
+	{
+		if (UWallRunAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UWallRunAudioSubsystem>())
+		{
+			AudioSubsystem->StopLoop(this);
+		}
+	}
+}
+
+void UWallRunComponent::ResetWallRunState()
+{
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+	if (FWallRunDefaultPolicy::bAudio && bOnWall && !WallRunSound.IsNull())
+	{
+		if (UWallRunAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UWallRunAudioSubsystem>())
+		{
+			AudioSubsystem->StopLoop(this);
+		}
+	}
+	if (MoveComp)
 	{
-		AudioRunComp->Stop();
+		MoveComp->GravityScale = DefaultGravity;
+		MoveComp->AirControl = DefaultAirControl;
+		MoveComp->RemoveRootMotionSource(FRootMotionSource_WallRunLedgeClimb::InstanceNameDefault);
 	}
+
+	bOnWall = false;
+	bOnFloor = true;
+	bCanJumpFromWall = false;
+	bClimbingLedge = false;
+	bClimbFailRecorded = false;
+	WallNormal = FVector::ZeroVector;
+	WallDirection = FVector::ZeroVector;
+	LastWallSide = 0.f;
+	WallLostTime = 0.f;
+	TimeSinceWallTrace = 0.f;
+	TimeSinceAcquisition = 0.f;
+	BufferedJumpTime = -1.f;
+	BufferedDetachTime = -1.f;
+	Kinematics = FWallRunKinematics();
 }
 
 void UWallRunComponent::CoyoteTime_Elapsed()
@@ -203,25 +381,350 @@ void UWallRunComponent::CoyoteTime_Elapsed()
 }
 
 void UWallRunComponent::WallJump()
+{
+	if (bLeanFeatures)
+	{
+		WallJumpImpl<FWallRunLeanPolicy>();
+	}
+	else
+	{
+		WallJumpImpl<FWallRunDefaultPolicy>();
+	}
+}
+
+template <typename TPolicy>
+void UWallRunComponent::WallJumpImpl()
 {
 	if (bCanJumpFromWall)
 	{
-		if (DebugLog)
-			UE_LOG(LogTemp, Log, TEXT("Wall jump"));
+		WALLRUN_DEBUG_LOG(TPolicy, TEXT("Wall jump"));
 		bCanJumpFromWall = false;
-		OffWall();
-		FVector Velocity = MoveComp->Velocity;
-		float MovementImpulse = Velocity.Size();
-		Velocity.Normalize();
-		Velocity.Z = 0.f;
-		// WallJumpVelocity = (strength away from wall) + (strength in direction of player input movement) + (strength up) + (momentum)
-		FVector WallJumpVelocity = (WallNormal * LaunchStrengthNormal) + (MoveComp->GetLastInputVector() * LaunchStrengthLook) +
- 							(FVector::UpVector * LaunchStrengthZ) + (Velocity * MovementImpulse);
-		WallJumpVelocity = UKismetMathLibrary::ClampVectorSize(WallJumpVelocity, 0.f, MaxWallJumpVelocity);
+		OffWallImpl<TPolicy>(EWallRunOffWallReason::Jump);
+		const FVector WallJumpVelocity = CalculateWallJumpVelocity(WallNormal, GetKinematics(), MoveComp->GetLastInputVector());
 		CompOwner->LaunchCharacter(WallJumpVelocity, true, true);
+		PushEventImpl<TPolicy>(EWallRunEventType::Jump, WallNormal, EWallRunOffWallReason::Other);
+	}
+}
+
+bool UWallRunComponent::FindLedgeTop(FVector& OutClimbTarget) const
+{
+	const UCapsuleComponent* Capsule = CompOwner->GetCapsuleComponent();
+	const float Radius = Capsule->GetScaledCapsuleRadius();
+	const float HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	const FVector Location = CompOwner->GetActorLocation();
+
+	// down onto the ledge just behind the wall face
+	FHitResult TopHit;
+	const FVector Above = Location - WallNormal * (Radius + LedgeForwardDistance);
+	const FVector Start = Above + FVector(0.f, 0.f, MaxLedgeHeight);
+	const FVector End = Above - FVector(0.f, 0.f, HalfHeight);
+	GetWorld()->LineTraceSingleByChannel(TopHit, Start, End, ECC_Visibility);
+	WALLRUN_PERF_COUNT(NumTraces);
+	if (!TopHit.bBlockingHit || TopHit.bStartPenetrating || TopHit.ImpactNormal.Z < MoveComp->GetWalkableFloorZ())
+	{
+		return false;
+	}
+
+	// standing capsule fits there, slightly above floor so it doesn't start penetrating
+	OutClimbTarget = TopHit.ImpactPoint + FVector(0.f, 0.f, HalfHeight + 2.f);
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(WallRunLedgeTop), false, CompOwner);
+	FCollisionResponseParams ResponseParams;
+	Capsule->InitSweepCollisionParams(Params, ResponseParams);
+	return !GetWorld()->OverlapBlockingTestByChannel(OutClimbTarget, Capsule->GetComponentQuat(), Capsule->GetCollisionObjectType(), Capsule->GetCollisionShape(), Params, ResponseParams);
+}
+
+void UWallRunComponent::StartLedgeClimb(const FVector& ClimbTarget)
+{
+	// called from OnHit during movement update, on owning client and server alike
+	TSharedPtr<FRootMotionSource_WallRunLedgeClimb> Climb = MakeShared<FRootMotionSource_WallRunLedgeClimb>();
+	Climb->InstanceName = FRootMotionSource_WallRunLedgeClimb::InstanceNameDefault;
+	Climb->AccumulateMode = ERootMotionAccumulateMode::Override;
+	Climb->Priority = 500;
+	Climb->Duration = ClimbDuration;
+	Climb->StartLocation = CompOwner->GetActorLocation();
+	Climb->TargetLocation = ClimbTarget;
+	Climb->RiseFraction = ClimbRiseFraction;
+	Climb->bRestrictSpeedToExpected = true;
+	// stop on the ledge instead of flying over it with climb speed
+	Climb->FinishVelocityParams.Mode = ERootMotionFinishVelocityMode::SetVelocity;
+	Climb->FinishVelocityParams.SetVelocity = FVector::ZeroVector;
+	MoveComp->ApplyRootMotionSource(Climb);
+}
+
+FVector UWallRunComponent::CalculateStickLaunchVelocity(const FVector& InWallNormal, const FWallRunKinematics& InKinematics, const FVector& InputVector) const
+{
+	const FVector InWallDirection = FVector::CrossProduct(FVector::UpVector, InWallNormal);
+	const FVector WallDirectionSide = InWallDirection * InKinematics.GetWallSide(); // make WallDirection point to the same direction as player
+
+	// calculate how much (strong) player is trying to move into the wall 
+	float StrengthOfSideLaunch = FMath::Abs(FVector::DotProduct(InWallDirection, InputVector));
+
+	// dont launch player along the wall if he touches wall moving backwards
+	if (InKinematics.ForwardDotVelocity < 0.f)
+	{
+		StrengthOfSideLaunch = StrengthOfSideLaunch * 0.2;
+	}
+
+	const FVector Momentum = FVector(InKinematics.VelocityDir.X, InKinematics.VelocityDir.Y, 0.f) * InKinematics.Speed;
+	// LaunchVelocity = (strength up) + (Strength in direction of look along the wall) + (Strength of momentum) + (impulse into wall)
+	return (FVector::UpVector * LaunchOnStickUp) + (WallDirectionSide * LaunchOnStickSide * StrengthOfSideLaunch) + 
+		(Momentum * MovementumAdjust) + (-InWallNormal * 100.f);
+}
+
+FVector UWallRunComponent::CalculateWallJumpVelocity(const FVector& InWallNormal, const FWallRunKinematics& InKinematics, const FVector& InputVector) const
+{
+	const FVector Momentum = FVector(InKinematics.VelocityDir.X, InKinematics.VelocityDir.Y, 0.f) * InKinematics.Speed;
+	// WallJumpVelocity = (strength away from wall) + (strength in direction of player input movement) + (strength up) + (momentum)
+	const FVector WallJumpVelocity = (InWallNormal * LaunchStrengthNormal) + (InputVector * LaunchStrengthLook) +
+		(FVector::UpVector * LaunchStrengthZ) + Momentum;
+	return UKismetMathLibrary::ClampVectorSize(WallJumpVelocity, 0.f, MaxWallJumpVelocity);
+}
+
+bool UWallRunComponent::PredictWallJump(FVector InputVector, FWallRunJumpPrediction& OutPrediction, float MaxTime) const
+{
+	TArray<FWallRunJumpPrediction> Predictions;
+	PredictWallJumps(MakeArrayView(&InputVector, 1), Predictions, MaxTime);
+	OutPrediction = Predictions.Num() > 0 ? Predictions[0] : FWallRunJumpPrediction();
+	return OutPrediction.bLands;
+}
+
+void UWallRunComponent::PredictWallJumps(TArrayView<const FVector> InputVectors, TArray<FWallRunJumpPrediction>& OutPredictions, float MaxTime) const
+{
+	OutPredictions.Reset(InputVectors.Num());
+	if (!CompOwner || !MoveComp || WallNormal.IsZero())
+	{
+		return;
+	}
+
+	const UCapsuleComponent* Capsule = CompOwner->GetCapsuleComponent();
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(WallJumpPrediction), false, CompOwner);
+	FCollisionResponseParams ResponseParams;
+	Capsule->InitSweepCollisionParams(Params, ResponseParams);
+	const FCollisionShape Shape = Capsule->GetCollisionShape();
+	const ECollisionChannel Channel = Capsule->GetCollisionObjectType();
+
+	const float GravityZ = GetWallJumpGravityZ();
+	const FVector Start = CompOwner->GetActorLocation();
+	// const, so can't refresh the member snapshot, a copy is updated with what changed
+	FWallRunKinematics Current = Kinematics;
+	Current.Update(CompOwner->GetActorQuat(), MoveComp->Velocity, WallNormal, WallDirection);
+
+	for (const FVector& InputVector : InputVectors)
+	{
+		FWallRunJumpPrediction& Prediction = OutPredictions.AddDefaulted_GetRef();
+		WallRunBallistics::PredictLanding(GetWorld(), Start, CalculateWallJumpVelocity(WallNormal, Current, InputVector), GravityZ,
+			Shape, Channel, Params, ResponseParams, MaxTime, PredictionTolerance, Prediction);
+	}
+}
+
+float UWallRunComponent::GetWallJumpGravityZ() const
+{
+	return GetWorld()->GetGravityZ() * (bOnWall || !MoveComp ? DefaultGravity : MoveComp->GravityScale);
+}
+
+void UWallRunComponent::PushEvent(EWallRunEventType Type, const FVector& Vector, EWallRunOffWallReason Reason)
+{
+	if (bLeanFeatures)
+	{
+		PushEventImpl<FWallRunLeanPolicy>(Type, Vector, Reason);
+	}
+	else
+	{
+		PushEventImpl<FWallRunDefaultPolicy>(Type, Vector, Reason);
+	}
+}
+
+template <typename TPolicy>
+void UWallRunComponent::PushEventImpl(EWallRunEventType Type, const FVector& Vector, EWallRunOffWallReason Reason)
+{
+	FWallRunEvent Event;
+	Event.Type = Type;
+	Event.Reason = Reason;
+	Event.CharacterId = CharacterId;
+	Event.Time = GetWorld()->GetTimeSeconds();
+	Event.Location = CompOwner->GetActorLocation();
+	Event.Vector = Vector;
+	Event.Velocity = MoveComp->Velocity;
+	Event.Source = this;
+
+	// blueprint events are gameplay, only subscribers and trace are skipped without telemetry
+	if (!TPolicy::bTelemetry)
+	{
+		BroadcastEvent(Event);
+		return;
+	}
+
+	// every state change (stick, unstick, wall jump, ledge climb, land) goes through here
+	TRACE_WALLRUN_STATE_CHANGE(Event, CompOwner);
+
+	if (UWallRunEventBus* EventBus = GetWorld()->GetSubsystem<UWallRunEventBus>())
+	{
+		EventBus->Push(Event);
+	}
+	else
+	{
+		BroadcastEvent(Event);
+	}
+}
+
+void UWallRunComponent::BroadcastEvent(const FWallRunEvent& Event)
+{
+	switch (Event.Type)
+	{
+	case EWallRunEventType::Stick:
+		// in blueprint: if no mouse input make camera look forward along the wall
+		OnWallEvent.Broadcast(Event.Vector);
+		break;
+	case EWallRunEventType::Unstick:
+		OffWallEvent.Broadcast();
+		break;
+	case EWallRunEventType::Climb:
+		ClimbEvent.Broadcast(Event.Vector);
+		break;
+	default:
+		break;
+	}
+}
+
+
+void UWallRunComponent::BufferJump()
+{
+	// jump from the floor is not buffered, otherwise it would wall jump right after touching the wall
+	if (!MoveComp || !MoveComp->IsFalling())
+	{
+		return;
+	}
+	BufferedJumpTime = GetWorld()->GetTimeSeconds();
+	++NumBufferedInputs;
+	++GWallRunBufferedInputs;
+	INC_DWORD_STAT(STAT_WallRunBufferedInputs);
+	UpdateBufferedInputHitRateStat();
+}
+
+void UWallRunComponent::BufferDetach()
+{
+	if (!MoveComp || !MoveComp->IsFalling())
+	{
+		return;
+	}
+	BufferedDetachTime = GetWorld()->GetTimeSeconds();
+	++NumBufferedInputs;
+	++GWallRunBufferedInputs;
+	INC_DWORD_STAT(STAT_WallRunBufferedInputs);
+	UpdateBufferedInputHitRateStat();
+}
+
+bool UWallRunComponent::ConsumeBufferedJump()
+{
+	if (!bCanJumpFromWall)
+	{
+		return false;
+	}
+	return ConsumeBufferedInput(BufferedJumpTime);
+}
+
+bool UWallRunComponent::ConsumeBufferedInput(float& BufferedTime)
+{
+	if (BufferedTime < 0.f)
+	{
+		return false;
+	}
+	const bool bInTime = GetWorld()->GetTimeSeconds() - BufferedTime <= InputBufferTime;
+	BufferedTime = -1.f;
+	if (bInTime)
+	{
+		++NumBufferedInputHits;
+		++GWallRunBufferedInputHits;
+		INC_DWORD_STAT(STAT_WallRunBufferedInputHits);
+		UpdateBufferedInputHitRateStat();
+	}
+	return bInTime;
+}
+
+float UWallRunComponent::GetBufferedInputHitRate() const
+{
+	return NumBufferedInputs > 0 ? (float)NumBufferedInputHits / (float)NumBufferedInputs : 0.f;
+}
+
+void UWallRunComponent::SetAudioEnabled(bool bEnabled)
+{
+	if (bAudioEnabled == bEnabled)
+	{
+		return;
+	}
+	bAudioEnabled = bEnabled;
+	if (!FWallRunDefaultPolicy::bAudio || bLeanFeatures)
+	{
+		return;
+	}
+	if (UWallRunAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UWallRunAudioSubsystem>())
+	{
+		if (!bEnabled)
+		{
+			AudioSubsystem->StopLoop(this);
+		}
+		else if (bOnWall && WallRunSound)
+		{
+			AudioSubsystem->PlayLoop(this, WallRunSound.Get(), CompOwner->GetRootComponent());
+		}
+	}
+}
+
+bool UWallRunComponent::IsSameWall(const FVector& Normal) const
+{
+	// no wall yet (on floor)
+	if (WallDirection.IsZero())
+	{
+		return false;
+	}
+	// wall normal is derived from WallDirection, so compare directions to handle both the same way
+	const FVector NewWallDirection = FVector::CrossProduct(FVector::UpVector, Normal).GetSafeNormal();
+	const float SameWallCos = FMath::Cos(FMath::DegreesToRadians(SameWallAngle));
+	return FVector::DotProduct(NewWallDirection, WallDirection.GetSafeNormal()) >= SameWallCos;
+}
+
+void UWallRunComponent::FollowWall(const FVector& Normal, float DeltaTime)
+{
+	WallNormal = FMath::VInterpTo(WallNormal, Normal, DeltaTime, WallNormalInterpSpeed).GetSafeNormal();
+	WallDirection = FVector::CrossProduct(FVector::UpVector, WallNormal);
+}
+
+void FWallRunKinematics::Update(const FQuat& Rotation, const FVector& Velocity, const FVector& WallNormal, const FVector& WallDirection)
+{
+	const bool bSameRotation = SourceRotation == Rotation;
+	if (bSameRotation && SourceVelocity == Velocity && SourceWallNormal == WallNormal && SourceWallDirection == WallDirection)
+	{
+		return;
+	}
+
+	if (!bSameRotation)
+	{
+		Forward = Rotation.GetForwardVector();
+	}
+	if (!bSameRotation || SourceVelocity != Velocity)
+	{
+		Speed = Velocity.Size();
+		VelocityDir = Speed > SMALL_NUMBER ? Velocity / Speed : FVector::ZeroVector;
+		ForwardDotVelocity = FVector::DotProduct(Forward, VelocityDir);
 	}
+	VelocityDotWallNormal = FVector::DotProduct(WallNormal, VelocityDir);
+	VelocityDotWallDirection = FVector::DotProduct(WallDirection, VelocityDir);
+	ForwardDotWallNormal = FVector::DotProduct(WallNormal, Forward);
+
+	SourceRotation = Rotation;
+	SourceVelocity = Velocity;
+	SourceWallNormal = WallNormal;
+	SourceWallDirection = WallDirection;
 }
 
+const FWallRunKinematics& UWallRunComponent::GetKinematics()
+{
+	if (CompOwner && MoveComp)
+	{
+		Kinematics.Update(CompOwner->GetActorQuat(), MoveComp->Velocity, WallNormal, WallDirection);
+	}
+	return Kinematics;
+}
 
 bool UWallRunComponent::IsCharacterMovingBackwards()
 {
@@ -229,19 +732,15 @@ bool UWallRunComponent::IsCharacterMovingBackwards()
 	{
 		return false;
 	}
-	// calculate how relative actor look direction to direction of movement 
-	FVector Velocity = MoveComp->Velocity;
-	Velocity.Normalize();
 	// if negative then player looks in the opposite direction from movement, meaning - moves backwards
-	float MovementDirection = FVector::DotProduct(CompOwner->GetActorForwardVector(), Velocity);
-	return MovementDirection < 0.0f ? true : false;
+	return GetKinematics().ForwardDotVelocity < 0.0f;
 }
 
 bool UWallRunComponent::IsCharacterLookingAtWall(float Threshold)
 {
 	if (CompOwner && bOnWall)
 	{
-		float LookAtWall = FVector::DotProduct(-WallNormal, CompOwner->GetActorForwardVector());
+		float LookAtWall = -GetKinematics().ForwardDotWallNormal;
 		if (LookAtWall > Threshold)
 		{
 			return true;
@@ -258,47 +757,230 @@ float UWallRunComponent::CalculateWallSide()
 		return 0.f;
 	}
 
-	FVector CharVelocity = MoveComp->Velocity;
-	CharVelocity.Normalize();
-	float WallSide = FVector::DotProduct(WallDirection, CharVelocity);
-	if (WallSide < 0.f)
+	return GetKinematics().GetWallSide();
+}
+
+// Called every frame
+void UWallRunComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WallRunTick);
+	WALLRUN_PERF_TICK_SCOPE();
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (bLeanFeatures)
 	{
-		return -1.f;
+		TickWallRun<FWallRunLeanPolicy>(DeltaTime);
 	}
 	else
 	{
-		return 1.f;
+		TickWallRun<FWallRunDefaultPolicy>(DeltaTime);
 	}
 }
 
-// Called every frame
-void UWallRunComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+template <typename TPolicy>
+void UWallRunComponent::TickWallRun(float DeltaTime)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
 	if (bOnWall)
 	{
 		// stop wallrunning if player moves away from wall 
-		FVector CharVelocity = MoveComp->Velocity;
-		CharVelocity.Normalize();
-		float DeviationFromWall = FVector::DotProduct(WallNormal, CharVelocity);
+		float DeviationFromWall = GetKinematics().VelocityDotWallNormal;
 		
 		if (DeviationFromWall > AllowedDeviationFromWall)
 		{
-			OffWall();
-			if (DebugLog)
-				UE_LOG(LogTemp, Log, TEXT("Moved away from wall"));
+			OffWallImpl<TPolicy>(EWallRunOffWallReason::Deviation);
+			WALLRUN_DEBUG_LOG(TPolicy, TEXT("Moved away from wall"));
+			return;
+		}
+
+		// trace less often for far away characters
+		TimeSinceWallTrace += DeltaTime;
+		if (TimeSinceWallTrace < WallTraceInterval)
+		{
+			return;
 		}
+		const float TraceDeltaTime = TimeSinceWallTrace;
+		TimeSinceWallTrace = 0.f;
 
-		// stop wallrunning if wall ends (detect edge of wall)
+		// follow the wall while it curves, stop wallrunning if wall ends (detect edge of wall)
 		FHitResult Hit;
 		FVector Start = CompOwner->GetActorLocation();
-		FVector End = Start + (-WallNormal) * 100;
+		FVector End = Start + (-WallNormal) * WallTraceLength;
 		GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility);
-		if (!Hit.bBlockingHit)
+		WALLRUN_PERF_COUNT(NumTraces);
+		if (Hit.bBlockingHit && IsSameWall(Hit.ImpactNormal))
 		{
-			OffWall();
+			WallLostTime = 0.f;
+			FollowWall(Hit.ImpactNormal, TraceDeltaTime);
 		}
-;	}
+		else
+		{
+			WallLostTime += TraceDeltaTime;
+			if (WallLostTime > WallLostGraceTime)
+			{
+				OffWallImpl<TPolicy>(EWallRunOffWallReason::WallEnd);
+				WALLRUN_DEBUG_LOG(TPolicy, TEXT("Wall ended"));
+			}
+		}
+	}
+	else if (bPredictiveWallAcquisition && !bClimbingLedge && MoveComp && MoveComp->IsFalling() && GetNetMode() == NM_Standalone)
+	{
+		TryAcquireWall<TPolicy>(DeltaTime);
+	}
 }
 
+template <typename TPolicy>
+void UWallRunComponent::TryAcquireWall(float DeltaTime)
+{
+	TimeSinceAcquisition += DeltaTime;
+	const float Interval = FMath::Max(AcquisitionInterval, WallTraceInterval);
+	if (TimeSinceAcquisition < Interval)
+	{
+		return;
+	}
+	TimeSinceAcquisition = 0.f;
+
+	const FVector Velocity = MoveComp->Velocity;
+	const float Speed = Velocity.Size();
+	if (Speed < KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	// crouch pressed just before the wall, OnHit skips it when it's touched
+	if (BufferedDetachTime >= 0.f && GetWorld()->GetTimeSeconds() - BufferedDetachTime <= InputBufferTime)
+	{
+		return;
+	}
+
+	const UCapsuleComponent* Capsule = CompOwner->GetCapsuleComponent();
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(WallRunAcquisition), false, CompOwner);
+	FCollisionResponseParams ResponseParams;
+	Capsule->InitSweepCollisionParams(Params, ResponseParams);
+
+	// only what the character would reach this frame anyway, sticking earlier would pull it sideways to a distant wall
+	FHitResult Hit;
+	const FVector Start = CompOwner->GetActorLocation();
+	const float SweepDistance = Speed * DeltaTime;
+	GetWorld()->SweepSingleByChannel(Hit, Start, Start + Velocity / Speed * SweepDistance, Capsule->GetComponentQuat(), Capsule->GetCollisionObjectType(), Capsule->GetCollisionShape(), Params, ResponseParams);
+	WALLRUN_PERF_COUNT(NumTraces);
+	if (!Hit.bBlockingHit || Hit.bStartPenetrating || !Hit.Component.IsValid())
+	{
+		return;
+	}
+
+	// same wall test as OnHit
+	const float Verticality = FMath::RoundHalfFromZero(Hit.ImpactNormal.Z);
+	if (Verticality != 0.f || !ObjectTypesForWallRun.Contains(Hit.Component->GetCollisionObjectType()) || IsSameWall(Hit.ImpactNormal))
+	{
+		return;
+	}
+
+	// touch the wall first, stick push into it then starts at the contact like after OnHit
+	FHitResult MoveHit;
+	MoveComp->SafeMoveUpdatedComponent(Hit.Location - Start, Capsule->GetComponentQuat(), true, MoveHit);
+	if (bOnWall)
+	{
+		// move touched the wall and OnHit already stuck
+		return;
+	}
+
+	WALLRUN_DEBUG_LOG(TPolicy, TEXT("Wall acquired %.1f cm ahead"), Hit.Time * SweepDistance);
+	INC_DWORD_STAT(STAT_WallRunPredictiveSticks);
+	WallNormal = Hit.ImpactNormal.GetSafeNormal2D();
+	StickToWallImpl<TPolicy>();
+}
+
+
+
+// stick / follow wall / unstick cycles of one component with each feature set.
+// default policy with DebugLog off is what every component ran before feature sets
+struct FWallRunPolicyBenchmark
+{
+	template <typename TPolicy>
+	static double Run(UWallRunComponent* Comp, int32 NumCycles)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumCycles; ++i)
+		{
+			Comp->WallNormal = FVector::ForwardVector;
+			Comp->StickToWallImpl<TPolicy>();
+			// nothing to trace far below the level, so wall is lost after WallLostGraceTime
+			for (int32 Tick = 0; Tick < 4 && Comp->bOnWall; ++Tick)
+			{
+				Comp->TickWallRun<TPolicy>(1.f / 60.f);
+			}
+			if (Comp->bOnWall)
+			{
+				Comp->OffWallImpl<TPolicy>(EWallRunOffWallReason::Other);
+			}
+			Comp->ResetWallRunState();
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / FMath::Max(NumCycles, 1);
+	}
+};
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkFeaturePoliciesCmd(
+	TEXT("WallRun.BenchmarkFeaturePolicies"),
+	TEXT("WallRun.BenchmarkFeaturePolicies [Cycles=10000] [WallRunSound]. Times wallrun cycles with default, server (no audio) and lean feature sets.\n")
+	TEXT("Default set plays wallrun loop of the player's character unless a sound asset path is given"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 NumCycles = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ACharacter* Character = World->SpawnActor<ACharacter>(ACharacter::StaticClass(), FVector(0.f, 0.f, -100000.f), FRotator::ZeroRotator, SpawnParams);
+		if (!Character)
+		{
+			return;
+		}
+		// registered after owner's BeginPlay, so component's BeginPlay runs here
+		UWallRunComponent* Comp = NewObject<UWallRunComponent>(Character);
+		Comp->RegisterComponent();
+
+		// wallrun loop of the player (or given asset), audio is what default and server sets differ in
+		APlayerController* PC = World->GetFirstPlayerController();
+		const UWallRunComponent* PlayerWallRun = PC && PC->GetPawn() ? PC->GetPawn()->FindComponentByClass<UWallRunComponent>() : nullptr;
+		if (Args.Num() > 1)
+		{
+			Comp->WallRunSound = TSoftObjectPtr<USoundBase>(FSoftObjectPath(Args[1]));
+		}
+		else if (PlayerWallRun)
+		{
+			Comp->WallRunSound = PlayerWallRun->WallRunSound;
+		}
+		Comp->WallRunSound.LoadSynchronous();
+		Comp->SetAudioEnabled(true);
+		UWallRunAudioSubsystem* AudioSubsystem = World->GetSubsystem<UWallRunAudioSubsystem>();
+		const float OldMaxAudibleDistance = AudioSubsystem ? AudioSubsystem->MaxAudibleDistance : 0.f;
+		if (!Comp->WallRunSound || !AudioSubsystem || !World->GetAudioDeviceRaw())
+		{
+			UE_LOG(LogWallRunComponent, Warning, TEXT("No wallrun sound or audio device, default set won't play any audio"));
+		}
+		else
+		{
+			// character is far below the level, where nothing can be traced, listener wouldn't hear it there
+			AudioSubsystem->MaxAudibleDistance = WORLD_MAX;
+		}
+
+		using FServerPolicy = TWallRunFeaturePolicy<FWallRunDefaultPolicy::bLedgeClimb, FWallRunDefaultPolicy::bCoyoteTime, false, FWallRunDefaultPolicy::bDebugLog, FWallRunDefaultPolicy::bTelemetry>;
+		FWallRunPolicyBenchmark::Run<FWallRunDefaultPolicy>(Comp, FMath::Min(NumCycles, 100));
+		const double DefaultNs = FWallRunPolicyBenchmark::Run<FWallRunDefaultPolicy>(Comp, NumCycles);
+		const double ServerNs = FWallRunPolicyBenchmark::Run<FServerPolicy>(Comp, NumCycles);
+		const double LeanNs = FWallRunPolicyBenchmark::Run<FWallRunLeanPolicy>(Comp, NumCycles);
+		if (AudioSubsystem)
+		{
+			AudioSubsystem->MaxAudibleDistance = OldMaxAudibleDistance;
+		}
+
+		UE_LOG(LogWallRunComponent, Display, TEXT("%d wallrun cycles (stick, follow wall, unstick):"), NumCycles);
+		UE_LOG(LogWallRunComponent, Display, TEXT("  default (runtime checks) %8.0f ns"), DefaultNs);
+		UE_LOG(LogWallRunComponent, Display, TEXT("  server (no audio)        %8.0f ns (%.2fx)"), ServerNs, DefaultNs / FMath::Max(ServerNs, 1.0));
+		UE_LOG(LogWallRunComponent, Display, TEXT("  lean                     %8.0f ns (%.2fx)"), LeanNs, DefaultNs / FMath::Max(LeanNs, 1.0));
+
+		Character->Destroy();
+	}));
@@ -0,0 +1,238 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunCourseGenerator.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+#include "UObject/ConstructorHelpers.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunCourse, Log, All);
+
+
+static UHierarchicalInstancedStaticMeshComponent* CreateCourseISM(AActor* Owner, FName Name)
+{
+	UHierarchicalInstancedStaticMeshComponent* ISM = Owner->CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(Name);
+	ISM->SetupAttachment(Owner->GetRootComponent());
+	ISM->SetMobility(EComponentMobility::Static);
+	ISM->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	ISM->SetCollisionObjectType(ECC_WorldStatic);
+	// course pieces are only run on and traced against, overlaps are never needed
+	ISM->SetGenerateOverlapEvents(false);
+	return ISM;
+}
+
+AWallRunCourseGenerator::AWallRunCourseGenerator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube"));
+	BlockMesh = CubeMesh.Object;
+
+	// mesh is set before registration, courses spawned in play (WallRun.GenerateCourse) never have to change it
+	Walls = CreateCourseISM(this, TEXT("Walls"));
+	Walls->SetStaticMesh(BlockMesh);
+	Pillars = CreateCourseISM(this, TEXT("Pillars"));
+	Pillars->SetStaticMesh(BlockMesh);
+	Ledges = CreateCourseISM(this, TEXT("Ledges"));
+	Ledges->SetStaticMesh(BlockMesh);
+
+	Seed = 0;
+	NumSegments = 100;
+	NumLanes = 4;
+	LaneWidth = 2000.f;
+	WallLength = FVector2D(600.f, 2000.f);
+	WallHeight = FVector2D(400.f, 900.f);
+	WallGap = FVector2D(200.f, 700.f);
+	WallSpacing = 500.f;
+	PillarChance = 0.3f;
+	LedgeChance = 0.2f;
+	SpawnPointsPerLane = 4;
+	bGenerateOnConstruction = false;
+	bGenerateOnBeginPlay = false;
+
+	// settings are sent once, every machine builds the instances itself
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 1.f;
+}
+
+void AWallRunCourseGenerator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AWallRunCourseGenerator, Seed, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(AWallRunCourseGenerator, NumSegments, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(AWallRunCourseGenerator, NumLanes, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(AWallRunCourseGenerator, bGenerateOnBeginPlay, COND_InitialOnly);
+}
+
+void AWallRunCourseGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bGenerateOnBeginPlay)
+	{
+		Generate();
+	}
+}
+
+void AWallRunCourseGenerator::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	if (bGenerateOnConstruction)
+	{
+		Generate();
+	}
+}
+
+FTransform AWallRunCourseGenerator::MakeBlock(const FVector& Center, const FVector& Size, float Yaw)
+{
+	// engine cube is 100 cm with pivot in the center
+	return FTransform(FRotator(0.f, Yaw, 0.f), Center, Size / 100.f);
+}
+
+void AWallRunCourseGenerator::Clear()
+{
+	Walls->ClearInstances();
+	Pillars->ClearInstances();
+	Ledges->ClearInstances();
+	SpawnPoints.Empty();
+}
+
+void AWallRunCourseGenerator::Generate()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	Clear();
+
+	// registered static components refuse a new mesh once play has begun, those are made movable first
+	const bool bGameWorld = GetWorld() && GetWorld()->IsGameWorld();
+	for (UHierarchicalInstancedStaticMeshComponent* ISM : { Walls, Pillars, Ledges })
+	{
+		if (ISM->GetStaticMesh() == BlockMesh)
+		{
+			continue;
+		}
+		if (bGameWorld)
+		{
+			ISM->SetMobility(EComponentMobility::Movable);
+		}
+		ISM->SetStaticMesh(BlockMesh);
+	}
+
+	constexpr float WallThickness = 40.f;
+	constexpr float PillarSize = 80.f;
+	constexpr float LedgeDepth = 300.f;
+
+	FRandomStream Random(Seed);
+	TArray<FTransform> WallInstances;
+	TArray<FTransform> PillarInstances;
+	TArray<FTransform> LedgeInstances;
+	WallInstances.Reserve(NumSegments * NumLanes);
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		const float LaneY = Lane * LaneWidth;
+
+		for (int32 Spawn = 0; Spawn < SpawnPointsPerLane; ++Spawn)
+		{
+			const float SpawnY = LaneY + (Spawn - (SpawnPointsPerLane - 1) * 0.5f) * 150.f;
+			SpawnPoints.Add(FTransform(FRotator::ZeroRotator, FVector(-500.f, SpawnY, 100.f)));
+		}
+
+		float X = 0.f;
+		for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			// walls alternate sides so the course can be run as wall-jump chain
+			const float Side = (Segment % 2 == 0) ? 1.f : -1.f;
+			const float Length = Random.FRandRange(WallLength.X, WallLength.Y);
+			const float Height = Random.FRandRange(WallHeight.X, WallHeight.Y);
+			const float Y = LaneY + Side * (WallSpacing * 0.5f + Random.FRandRange(-50.f, 50.f));
+			const float Yaw = Random.FRandRange(-10.f, 10.f);
+
+			WallInstances.Add(MakeBlock(FVector(X + Length * 0.5f, Y, Height * 0.5f), FVector(Length, WallThickness, Height), Yaw));
+
+			// ledge on top of wall end to climb on
+			if (Random.FRand() < LedgeChance)
+			{
+				const FVector LedgeCenter(X + Length + LedgeDepth * 0.5f, Y, Height - 50.f);
+				LedgeInstances.Add(MakeBlock(LedgeCenter, FVector(LedgeDepth, WallSpacing, 100.f)));
+			}
+
+			const float Gap = Random.FRandRange(WallGap.X, WallGap.Y);
+			if (Random.FRand() < PillarChance)
+			{
+				const float PillarHeight = Random.FRandRange(WallHeight.X, WallHeight.Y);
+				PillarInstances.Add(MakeBlock(FVector(X + Length + Gap * 0.5f, LaneY, PillarHeight * 0.5f), FVector(PillarSize, PillarSize, PillarHeight)));
+			}
+			X += Length + Gap;
+		}
+	}
+
+	// batch add - one tree build per component instead of one per instance
+	Walls->AddInstances(WallInstances, false);
+	Pillars->AddInstances(PillarInstances, false);
+	Ledges->AddInstances(LedgeInstances, false);
+
+	UE_LOG(LogWallRunCourse, Log, TEXT("Generated course (seed %d): %d walls, %d pillars, %d ledges, %d spawn points in %.2f ms"),
+		Seed, WallInstances.Num(), PillarInstances.Num(), LedgeInstances.Num(), SpawnPoints.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+// spawns generated course in front of the world origin, for profiling in PIE or standalone
+static FAutoConsoleCommandWithWorldAndArgs GenerateCourseCmd(
+	TEXT("WallRun.GenerateCourse"),
+	TEXT("Spawns a wallrun stress course. Args: [Seed] [NumSegments] [NumLanes]. In network games runs on server, clients get the course replicated"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		// in PIE the command may come from a client world, the course is spawned on server and replicates from there
+		if (World->GetNetMode() == NM_Client)
+		{
+			World = nullptr;
+			for (const FWorldContext& Context : GEngine->GetWorldContexts())
+			{
+				UWorld* ContextWorld = Context.World();
+				if (ContextWorld && ContextWorld->IsGameWorld() && ContextWorld->GetNetDriver() && ContextWorld->GetNetDriver()->IsServer())
+				{
+					World = ContextWorld;
+					break;
+				}
+			}
+			if (!World)
+			{
+				UE_LOG(LogWallRunCourse, Warning, TEXT("WallRun.GenerateCourse runs on server, courses replicate to clients"));
+				return;
+			}
+		}
+		// replace previously spawned course
+		for (TActorIterator<AWallRunCourseGenerator> It(World); It; ++It)
+		{
+			It->Destroy();
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.bDeferConstruction = true;
+		AWallRunCourseGenerator* Generator = World->SpawnActor<AWallRunCourseGenerator>(FVector(0.f, 0.f, 0.f), FRotator::ZeroRotator, SpawnParams);
+		if (!Generator)
+		{
+			return;
+		}
+		Generator->Seed = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0;
+		Generator->NumSegments = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : Generator->NumSegments;
+		Generator->NumLanes = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : Generator->NumLanes;
+		Generator->bGenerateOnBeginPlay = true;
+		Generator->FinishSpawning(FTransform::Identity);
+	}));
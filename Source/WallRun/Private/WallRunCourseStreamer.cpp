@@ -0,0 +1,486 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunCourseStreamer.h"
+#include "WallRun.h"
+#include "WallRunComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunStreaming, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Course Chunks"), STAT_WallRunResidentChunks, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loading Course Chunks"), STAT_WallRunLoadingChunks, STATGROUP_WallRun);
+DECLARE_CYCLE_STAT(TEXT("WallRun Course Streaming"), STAT_WallRunCourseStreaming, STATGROUP_WallRun);
+
+
+AWallRunCourseStreamer::AWallRunCourseStreamer()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	// after pawns moved this frame
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	LoadRadius = 3000.f;
+	UnloadRadius = 6000.f;
+	LookAheadTime = 3.f;
+	PathRadius = 1500.f;
+	PathSamples = 6;
+	MaxConcurrentLoads = 2;
+	UpdateInterval = 0.1f;
+	UpdateTimer = 0.f;
+}
+
+void AWallRunCourseStreamer::CollectChunks()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	Chunks.Reset();
+	for (ULevelStreaming* Streaming : World->GetStreamingLevels())
+	{
+		ULevel* Level = Streaming ? Streaming->GetLoadedLevel() : nullptr;
+		if (!Level)
+		{
+			continue;
+		}
+		FWallRunCourseChunk& Chunk = Chunks.AddDefaulted_GetRef();
+		Chunk.Level = Streaming->GetWorldAsset();
+		Chunk.Bounds = ALevelBounds::CalculateLevelBounds(Level);
+	}
+	UE_LOG(LogWallRunStreaming, Log, TEXT("%s: collected %d chunks"), *GetName(), Chunks.Num());
+}
+
+void AWallRunCourseStreamer::BeginPlay()
+{
+	Super::BeginPlay();
+
+	States.SetNum(Chunks.Num());
+	ResetStats();
+}
+
+void AWallRunCourseStreamer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SET_DWORD_STAT(STAT_WallRunResidentChunks, 0);
+	SET_DWORD_STAT(STAT_WallRunLoadingChunks, 0);
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWallRunCourseStreamer::ResetStats()
+{
+	Stats = FWallRunStreamingStats();
+}
+
+int32 AWallRunCourseStreamer::GetNumResidentChunks() const
+{
+	int32 NumResident = 0;
+	for (const FChunkState& State : States)
+	{
+		NumResident += State.bVisible ? 1 : 0;
+	}
+	return NumResident;
+}
+
+void AWallRunCourseStreamer::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	SCOPE_CYCLE_COUNTER(STAT_WallRunCourseStreaming);
+
+	Stats.Time += DeltaSeconds;
+	GatherViewers(DeltaSeconds);
+	PollChunks(DeltaSeconds);
+
+	UpdateTimer -= DeltaSeconds;
+	if (UpdateTimer <= 0.f)
+	{
+		UpdateTimer = UpdateInterval;
+		UpdateChunks();
+	}
+}
+
+void AWallRunCourseStreamer::GatherViewers(float DeltaSeconds)
+{
+	Viewers.Reset();
+	// server sees every player controller, client only its own
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APawn* Pawn = It->IsValid() ? (*It)->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		FViewer& Viewer = Viewers.AddDefaulted_GetRef();
+		Viewer.Location = Pawn->GetActorLocation();
+		Viewer.PredictedVelocity = Pawn->GetVelocity();
+
+		FVector& LastLocation = LastLocations.FindOrAdd(Pawn, Viewer.Location);
+		if (Viewer.PredictedVelocity.IsNearlyZero() && DeltaSeconds > 0.f)
+		{
+			Viewer.PredictedVelocity = (Viewer.Location - LastLocation) / DeltaSeconds;
+		}
+		LastLocation = Viewer.Location;
+
+		// on wall player keeps running along it, velocity may still point into the wall or upwards after stick
+		const UWallRunComponent* WallRun = Pawn->FindComponentByClass<UWallRunComponent>();
+		if (WallRun && WallRun->bOnWall && !WallRun->WallDirection.IsNearlyZero())
+		{
+			const float AlongWall = Viewer.PredictedVelocity | WallRun->WallDirection;
+			Viewer.PredictedVelocity = WallRun->WallDirection * (AlongWall >= 0.f ? 1.f : -1.f) * Viewer.PredictedVelocity.Size2D();
+		}
+	}
+
+	for (auto It = LastLocations.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void AWallRunCourseStreamer::PollChunks(float DeltaSeconds)
+{
+	int32 NumLoading = 0;
+	for (int32 i = 0; i < States.Num(); ++i)
+	{
+		FChunkState& State = States[i];
+		ULevelStreaming* Streaming = State.Streaming.Get();
+		const bool bVisible = Streaming && Streaming->IsLevelVisible();
+
+		if (bVisible && !State.bVisible && State.bRequested)
+		{
+			const float Latency = Stats.Time - State.RequestTime;
+			Stats.MaxLoadLatency = FMath::Max(Stats.MaxLoadLatency, Latency);
+			Stats.TotalLoadLatency += Latency;
+			if (State.PackageBytes < 0)
+			{
+				State.PackageBytes = GetPackageBytes(Streaming->GetWorldAssetPackageName());
+			}
+			Stats.BytesLoaded += State.PackageBytes;
+			++Stats.NumLoads;
+			UE_LOG(LogWallRunStreaming, Verbose, TEXT("%s visible after %.3f s"), *Streaming->GetWorldAssetPackageName(), Latency);
+		}
+		State.bVisible = bVisible;
+		NumLoading += (State.bRequested && !bVisible) ? 1 : 0;
+
+		// player got there before the chunk did
+		const bool bStalled = !bVisible && IsNearViewer(Chunks[i].Bounds, 0.f);
+		if (bStalled)
+		{
+			Stats.StallTime += DeltaSeconds;
+			if (!State.bStalled)
+			{
+				++Stats.NumStalls;
+				UE_LOG(LogWallRunStreaming, Warning, TEXT("Player entered chunk %d (%s) before it was loaded"), i, *Chunks[i].Level.GetAssetName());
+			}
+		}
+		State.bStalled = bStalled;
+	}
+
+	const int32 NumResident = GetNumResidentChunks();
+	Stats.PeakResidentChunks = FMath::Max(Stats.PeakResidentChunks, NumResident);
+	Stats.PeakUsedPhysical = FMath::Max<int64>(Stats.PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+	SET_DWORD_STAT(STAT_WallRunResidentChunks, NumResident);
+	SET_DWORD_STAT(STAT_WallRunLoadingChunks, NumLoading);
+}
+
+float AWallRunCourseStreamer::GetTimeToReach(const FBox& Bounds) const
+{
+	float BestTime = -1.f;
+	for (const FViewer& Viewer : Viewers)
+	{
+		for (int32 Sample = 1; Sample <= PathSamples; ++Sample)
+		{
+			const float Time = LookAheadTime * Sample / PathSamples;
+			if (BestTime >= 0.f && Time >= BestTime)
+			{
+				break;
+			}
+			const FVector Point = Viewer.Location + Viewer.PredictedVelocity * Time;
+			if (Bounds.ComputeSquaredDistanceToPoint(Point) <= FMath::Square(PathRadius))
+			{
+				BestTime = Time;
+				break;
+			}
+		}
+	}
+	return BestTime;
+}
+
+bool AWallRunCourseStreamer::IsNearViewer(const FBox& Bounds, float Radius) const
+{
+	for (const FViewer& Viewer : Viewers)
+	{
+		if (Bounds.ComputeSquaredDistanceToPoint(Viewer.Location) <= FMath::Square(Radius))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+float AWallRunCourseStreamer::GetDistSquaredToViewer(const FBox& Bounds) const
+{
+	float BestDistSquared = BIG_NUMBER;
+	for (const FViewer& Viewer : Viewers)
+	{
+		BestDistSquared = FMath::Min(BestDistSquared, Bounds.ComputeSquaredDistanceToPoint(Viewer.Location));
+	}
+	return BestDistSquared;
+}
+
+void AWallRunCourseStreamer::UpdateChunks()
+{
+	struct FLoadCandidate
+	{
+		int32 ChunkIndex;
+		float Time;
+		float DistSquared;
+	};
+	TArray<FLoadCandidate, TInlineAllocator<16>> Candidates;
+	int32 NumLoading = 0;
+
+	for (int32 i = 0; i < Chunks.Num(); ++i)
+	{
+		const FBox& Bounds = Chunks[i].Bounds;
+		FChunkState& State = States[i];
+		if (State.bUnavailable)
+		{
+			continue;
+		}
+
+		// around the player counts as reached now
+		const float Time = IsNearViewer(Bounds, LoadRadius) ? 0.f : GetTimeToReach(Bounds);
+		if (Time >= 0.f)
+		{
+			if (!State.bRequested)
+			{
+				Candidates.Add({ i, Time, GetDistSquaredToViewer(Bounds) });
+			}
+			else if (!State.bVisible)
+			{
+				++NumLoading;
+			}
+		}
+		else if (State.bRequested && !IsNearViewer(Bounds, UnloadRadius))
+		{
+			// behind or beside the path and far enough
+			RequestUnload(i);
+		}
+		else if (State.bRequested && !State.bVisible)
+		{
+			++NumLoading;
+		}
+	}
+
+	// chunks around the player first, closest first, then along the path by time to reach
+	Candidates.Sort([](const FLoadCandidate& A, const FLoadCandidate& B)
+	{
+		return A.Time != B.Time ? A.Time < B.Time : A.DistSquared < B.DistSquared;
+	});
+	for (const FLoadCandidate& Candidate : Candidates)
+	{
+		// only the chunk a viewer is standing in can't wait for the queue, the rest of load radius waits its turn
+		if (NumLoading >= MaxConcurrentLoads && Candidate.DistSquared > 0.f)
+		{
+			break;
+		}
+		RequestLoad(Candidate.ChunkIndex);
+		++NumLoading;
+	}
+}
+
+ULevelStreaming* AWallRunCourseStreamer::FindOrCreateStreamingLevel(int32 ChunkIndex)
+{
+	FChunkState& State = States[ChunkIndex];
+	if (ULevelStreaming* Streaming = State.Streaming.Get())
+	{
+		return Streaming;
+	}
+
+	const FWallRunCourseChunk& Chunk = Chunks[ChunkIndex];
+	const FName PackageName(*Chunk.Level.ToSoftObjectPath().GetLongPackageName());
+	UWorld* World = GetWorld();
+
+	// sublevel added in Levels window
+	for (ULevelStreaming* Streaming : World->GetStreamingLevels())
+	{
+		if (Streaming && Streaming->GetWorldAssetPackageFName() == PackageName)
+		{
+			State.Streaming = Streaming;
+			return Streaming;
+		}
+	}
+
+	// level instances get a unique name made up on each machine, so clients can't match server's instance
+	// (visibility updates, actors replicated from it). networked games need the chunk added in Levels window
+	if (World->GetNetMode() != NM_Standalone)
+	{
+		UE_LOG(LogWallRunStreaming, Error, TEXT("Course chunk %d (%s) isn't a sublevel of the persistent level, it can't be streamed in a networked game"),
+			ChunkIndex, *PackageName.ToString());
+		State.bUnavailable = true;
+		return nullptr;
+	}
+
+	// chunk not listed in persistent level, stream it in as an instance at its authored location
+	bool bSuccess = false;
+	ULevelStreamingDynamic* Streaming = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(World, Chunk.Level, FVector::ZeroVector, FRotator::ZeroRotator, bSuccess);
+	if (!bSuccess)
+	{
+		UE_LOG(LogWallRunStreaming, Error, TEXT("Can't stream course chunk %d (%s)"), ChunkIndex, *PackageName.ToString());
+		State.bUnavailable = true;
+		return nullptr;
+	}
+	State.Streaming = Streaming;
+	return Streaming;
+}
+
+void AWallRunCourseStreamer::RequestLoad(int32 ChunkIndex)
+{
+	ULevelStreaming* Streaming = FindOrCreateStreamingLevel(ChunkIndex);
+	if (!Streaming)
+	{
+		return;
+	}
+
+	FChunkState& State = States[ChunkIndex];
+	State.bRequested = true;
+	State.RequestTime = Stats.Time;
+	Streaming->SetShouldBeLoaded(true);
+	Streaming->SetShouldBeVisible(true);
+}
+
+void AWallRunCourseStreamer::RequestUnload(int32 ChunkIndex)
+{
+	FChunkState& State = States[ChunkIndex];
+	State.bRequested = false;
+	if (ULevelStreaming* Streaming = State.Streaming.Get())
+	{
+		Streaming->SetShouldBeVisible(false);
+		Streaming->SetShouldBeLoaded(false);
+	}
+	++Stats.NumUnloads;
+}
+
+int64 AWallRunCourseStreamer::GetPackageBytes(const FString& PackageName)
+{
+	FString Filename;
+	if (!FPackageName::DoesPackageExist(PackageName, nullptr, &Filename))
+	{
+		return 0;
+	}
+	// cooked packages keep exports in a separate file
+	const int64 ExportBytes = IFileManager::Get().FileSize(*FPaths::ChangeExtension(Filename, TEXT("uexp")));
+	return FMath::Max<int64>(IFileManager::Get().FileSize(*Filename), 0) + FMath::Max<int64>(ExportBytes, 0);
+}
+
+void AWallRunCourseStreamer::LogStats() const
+{
+	const float Time = FMath::Max(Stats.Time, KINDA_SMALL_NUMBER);
+	UE_LOG(LogWallRunStreaming, Display, TEXT("%s: %.1f s, %d chunks"), *GetName(), Stats.Time, Chunks.Num());
+	UE_LOG(LogWallRunStreaming, Display, TEXT("  loads %d, unloads %d, resident %d (peak %d)"), Stats.NumLoads, Stats.NumUnloads, GetNumResidentChunks(), Stats.PeakResidentChunks);
+	UE_LOG(LogWallRunStreaming, Display, TEXT("  load latency avg %.3f s, max %.3f s"), Stats.NumLoads > 0 ? Stats.TotalLoadLatency / Stats.NumLoads : 0.f, Stats.MaxLoadLatency);
+	UE_LOG(LogWallRunStreaming, Display, TEXT("  stalls %d, %.3f s total"), Stats.NumStalls, Stats.StallTime);
+	UE_LOG(LogWallRunStreaming, Display, TEXT("  streamed %.2f MB, %.2f MB/s"), Stats.BytesLoaded / (1024.f * 1024.f), Stats.BytesLoaded / (1024.f * 1024.f) / Time);
+	UE_LOG(LogWallRunStreaming, Display, TEXT("  used physical %.1f MB (peak %.1f MB)"), FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f), Stats.PeakUsedPhysical / (1024.f * 1024.f));
+}
+
+
+static FAutoConsoleCommandWithWorld StreamingReportCmd(
+	TEXT("WallRun.StreamingReport"),
+	TEXT("Prints course streaming stats (loads, stalls, latency, bandwidth, memory)"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TActorIterator<AWallRunCourseStreamer> It(World); It; ++It)
+		{
+			It->LogStats();
+		}
+	}));
+
+// automated fly-through: -game -ExecCmds="WallRun.StreamingFlythrough 2000"
+// local pawn is moved through chunk centers in Chunks order, stats are reset at start and printed at the end
+static FAutoConsoleCommandWithWorldAndArgs StreamingFlythroughCmd(
+	TEXT("WallRun.StreamingFlythrough"),
+	TEXT("WallRun.StreamingFlythrough [Speed=1500]. Moves local player through all course chunks and prints streaming stats"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		TActorIterator<AWallRunCourseStreamer> StreamerIt(World);
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr;
+		if (!StreamerIt || !Character)
+		{
+			UE_LOG(LogWallRunStreaming, Warning, TEXT("WallRun.StreamingFlythrough needs a course streamer and a local character"));
+			return;
+		}
+		AWallRunCourseStreamer* Streamer = *StreamerIt;
+
+		TArray<FVector> Path;
+		Path.Add(Character->GetActorLocation());
+		for (const FWallRunCourseChunk& Chunk : Streamer->Chunks)
+		{
+			if (Chunk.Bounds.IsValid)
+			{
+				Path.Add(Chunk.Bounds.GetCenter());
+			}
+		}
+		if (Path.Num() < 2)
+		{
+			return;
+		}
+
+		const float Speed = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 100.f) : 1500.f;
+		Streamer->ResetStats();
+		Character->GetCharacterMovement()->DisableMovement();
+		UE_LOG(LogWallRunStreaming, Display, TEXT("Flythrough of %d chunks at %.0f cm/s"), Path.Num() - 1, Speed);
+
+		TWeakObjectPtr<AWallRunCourseStreamer> WeakStreamer = Streamer;
+		TWeakObjectPtr<ACharacter> WeakCharacter = Character;
+		TSharedRef<int32> Segment = MakeShared<int32>(0);
+		TSharedRef<float> Distance = MakeShared<float>(0.f);
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakStreamer, WeakCharacter, Path, Speed, Segment, Distance](float DeltaTime)
+		{
+			AWallRunCourseStreamer* Streamer = WeakStreamer.Get();
+			ACharacter* Character = WeakCharacter.Get();
+			if (!Streamer || !Character)
+			{
+				return false;
+			}
+
+			*Distance += Speed * DeltaTime;
+			while (*Segment < Path.Num() - 1 && *Distance >= FVector::Dist(Path[*Segment], Path[*Segment + 1]))
+			{
+				*Distance -= FVector::Dist(Path[*Segment], Path[*Segment + 1]);
+				++*Segment;
+			}
+			if (*Segment >= Path.Num() - 1)
+			{
+				Character->SetActorLocation(Path.Last(), false, nullptr, ETeleportType::TeleportPhysics);
+				Character->GetCharacterMovement()->SetMovementMode(MOVE_Falling);
+				Streamer->LogStats();
+				return false;
+			}
+
+			const FVector Direction = (Path[*Segment + 1] - Path[*Segment]).GetSafeNormal();
+			Character->SetActorLocation(Path[*Segment] + Direction * *Distance, false, nullptr, ETeleportType::TeleportPhysics);
+			return true;
+		}));
+	}));
@@ -0,0 +1,116 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunEventBus.h"
+#include "WallRunComponent.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+
+
+void FWallRunEventBusTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Bus)
+	{
+		Bus->Dispatch();
+	}
+}
+
+void UWallRunEventBus::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	PendingEvents.Empty();
+	Super::Deinitialize();
+}
+
+void UWallRunEventBus::RegisterTickFunction()
+{
+	UWorld* World = GetWorld();
+	if (TickFunction.IsTickFunctionRegistered() || !World || !World->PersistentLevel)
+	{
+		return;
+	}
+	TickFunction.Bus = this;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bTickEvenWhenPaused = true;
+	TickFunction.TickGroup = DispatchTickGroup;
+	TickFunction.RegisterTickFunction(World->PersistentLevel);
+}
+
+void UWallRunEventBus::Push(const FWallRunEvent& Event)
+{
+	PendingEvents.Enqueue(Event);
+	if (IsInGameThread())
+	{
+		RegisterTickFunction();
+	}
+}
+
+TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe> UWallRunEventBus::AddThreadConsumer()
+{
+	TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe> Queue = MakeShared<FWallRunEventQueue, ESPMode::ThreadSafe>();
+	FScopeLock Lock(&ThreadConsumersLock);
+	ThreadConsumers.Add(Queue);
+	return Queue;
+}
+
+void UWallRunEventBus::RemoveThreadConsumer(const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& Queue)
+{
+	FScopeLock Lock(&ThreadConsumersLock);
+	ThreadConsumers.Remove(Queue);
+}
+
+void UWallRunEventBus::FlushToThreadConsumer(const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& Queue)
+{
+	// game thread is the only reader of pending events, take them out and put them back in order
+	TArray<FWallRunEvent> Pending;
+	FWallRunEvent Event;
+	while (PendingEvents.Dequeue(Event))
+	{
+		Pending.Add(Event);
+	}
+	for (const FWallRunEvent& PendingEvent : Pending)
+	{
+		Queue->Enqueue(PendingEvent);
+		PendingEvents.Enqueue(PendingEvent);
+	}
+}
+
+void UWallRunEventBus::Dispatch()
+{
+	Batch.Reset();
+	FWallRunEvent Event;
+	while (PendingEvents.Dequeue(Event))
+	{
+		Batch.Add(Event);
+	}
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&ThreadConsumersLock);
+		for (const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& Queue : ThreadConsumers)
+		{
+			for (const FWallRunEvent& QueuedEvent : Batch)
+			{
+				Queue->Enqueue(QueuedEvent);
+			}
+		}
+	}
+
+	OnEvents.Broadcast(Batch);
+
+	// blueprint events of the components
+	for (const FWallRunEvent& QueuedEvent : Batch)
+	{
+		if (UWallRunComponent* Source = QueuedEvent.Source.Get())
+		{
+			Source->BroadcastEvent(QueuedEvent);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunHeatmapCommandlet.h"
+#include "WallRunTelemetrySubsystem.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunHeatmap, Log, All);
+
+
+UWallRunHeatmapCommandlet::UWallRunHeatmapCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+static const TCHAR* GetEventName(uint8 Type)
+{
+	switch ((EWallRunEventType)Type)
+	{
+	case EWallRunEventType::Stick: return TEXT("Stick");
+	case EWallRunEventType::Unstick: return TEXT("Unstick");
+	case EWallRunEventType::Jump: return TEXT("WallJump");
+	case EWallRunEventType::Climb: return TEXT("Climb");
+	case EWallRunEventType::Land: return TEXT("Land");
+	case EWallRunEventType::ClimbFail: return TEXT("ClimbFail");
+	default: return TEXT("Unknown");
+	}
+}
+
+int32 UWallRunHeatmapCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens, Switches;
+	TMap<FString, FString> ParamMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamMap);
+
+	const FString InputDir = ParamMap.FindRef(TEXT("Input")).IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("Telemetry") : ParamMap.FindRef(TEXT("Input"));
+	const FString MapFilter = ParamMap.FindRef(TEXT("Map"));
+	const float CellSize = ParamMap.Contains(TEXT("CellSize")) ? FMath::Max(FCString::Atof(*ParamMap[TEXT("CellSize")]), 1.f) : 200.f;
+	const FString OutputPath = ParamMap.FindRef(TEXT("Output")).IsEmpty() ? InputDir / TEXT("Heatmap.csv") : ParamMap.FindRef(TEXT("Output"));
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(InputDir / (TEXT("*") + FString(FWallRunTelemetryRecord::GetFileExtension()))), true, false);
+
+	// (event, reason, cell x, cell y) -> count
+	TMap<FIntVector4, int32> Cells;
+	int32 NumRecords = 0;
+	for (const FString& File : Files)
+	{
+		if (!MapFilter.IsEmpty() && !File.StartsWith(MapFilter))
+		{
+			continue;
+		}
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *(InputDir / File)))
+		{
+			continue;
+		}
+		FMemoryReader FileReader(Data);
+		uint32 Magic = 0;
+		int32 UncompressedSize = 0;
+		int32 CompressedSize = 0;
+		FileReader << Magic << UncompressedSize << CompressedSize;
+		if (Magic != FWallRunTelemetryRecord::ChunkMagic || CompressedSize > Data.Num() - FileReader.Tell())
+		{
+			UE_LOG(LogWallRunHeatmap, Warning, TEXT("%s is not a wallrun telemetry file"), *File);
+			continue;
+		}
+
+		TArray<uint8> Records;
+		Records.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Records.GetData(), UncompressedSize, Data.GetData() + FileReader.Tell(), CompressedSize))
+		{
+			UE_LOG(LogWallRunHeatmap, Warning, TEXT("Failed to decompress %s"), *File);
+			continue;
+		}
+
+		FMemoryReader RecordReader(Records);
+		while (!RecordReader.AtEnd())
+		{
+			FWallRunTelemetryRecord Record;
+			RecordReader << Record;
+			const FIntVector4 Key(Record.Type, Record.Reason, FMath::FloorToInt(Record.Location.X / CellSize), FMath::FloorToInt(Record.Location.Y / CellSize));
+			++Cells.FindOrAdd(Key);
+			++NumRecords;
+		}
+	}
+
+	const UEnum* ReasonEnum = StaticEnum<EWallRunOffWallReason>();
+	FString Csv = TEXT("Event,Reason,CellX,CellY,WorldX,WorldY,Count\n");
+	for (const auto& Pair : Cells)
+	{
+		const FIntVector4& Key = Pair.Key;
+		// reason only means something for unstick
+		const FString Reason = (EWallRunEventType)Key.X == EWallRunEventType::Unstick ? ReasonEnum->GetNameStringByValue(Key.Y) : FString();
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d,%.0f,%.0f,%d\n"), GetEventName(Key.X), *Reason, Key.Z, Key.W,
+			(Key.Z + 0.5f) * CellSize, (Key.W + 0.5f) * CellSize, Pair.Value);
+	}
+	FFileHelper::SaveStringToFile(Csv, *OutputPath);
+
+	UE_LOG(LogWallRunHeatmap, Display, TEXT("%d events from %d files in %d cells -> %s"), NumRecords, Files.Num(), Cells.Num(), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,88 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunHistory.h"
+
+
+void FWallRunHistory::Init(int32 InCapacity)
+{
+	Capacity = FMath::Max(InCapacity, 2);
+	Times.SetNumZeroed(Capacity);
+	Locations.SetNumZeroed(Capacity);
+	Rotations.SetNumZeroed(Capacity);
+	CapsuleHalfHeights.SetNumZeroed(Capacity);
+	OnWall.SetNumZeroed(Capacity);
+	Reset();
+}
+
+void FWallRunHistory::Reset()
+{
+	Head = 0;
+	Count = 0;
+}
+
+void FWallRunHistory::Record(float Time, const FVector& Location, const FQuat& Rotation, float CapsuleHalfHeight, bool bOnWall)
+{
+	if (Capacity == 0)
+	{
+		return;
+	}
+	// same frame recorded twice - overwrite it
+	if (Count > 0 && Time <= GetNewestTime())
+	{
+		Head = (Head - 1 + Capacity) % Capacity;
+		--Count;
+	}
+	Times[Head] = Time;
+	Locations[Head] = Location;
+	Rotations[Head] = Rotation;
+	CapsuleHalfHeights[Head] = CapsuleHalfHeight;
+	OnWall[Head] = bOnWall;
+	Head = (Head + 1) % Capacity;
+	Count = FMath::Min(Count + 1, Capacity);
+}
+
+bool FWallRunHistory::Sample(float Time, FWallRunHistorySample& OutSample) const
+{
+	if (Count == 0)
+	{
+		return false;
+	}
+
+	// binary search for the first sample newer than Time
+	int32 Low = 0;
+	int32 High = Count;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Times[ToBufferIndex(Mid)] <= Time)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	// before oldest or after newest sample - clamp
+	if (Low == 0 || Low == Count)
+	{
+		const int32 Index = ToBufferIndex(Low == 0 ? 0 : Count - 1);
+		OutSample.Location = Locations[Index];
+		OutSample.Rotation = Rotations[Index];
+		OutSample.CapsuleHalfHeight = CapsuleHalfHeights[Index];
+		OutSample.bOnWall = OnWall[Index];
+		return true;
+	}
+
+	const int32 Before = ToBufferIndex(Low - 1);
+	const int32 After = ToBufferIndex(Low);
+	const float Alpha = (Time - Times[Before]) / FMath::Max(Times[After] - Times[Before], KINDA_SMALL_NUMBER);
+	OutSample.Location = FMath::Lerp(Locations[Before], Locations[After], Alpha);
+	OutSample.Rotation = FQuat::Slerp(Rotations[Before], Rotations[After], Alpha);
+	OutSample.CapsuleHalfHeight = FMath::Lerp(CapsuleHalfHeights[Before], CapsuleHalfHeights[After], Alpha);
+	OutSample.bOnWall = Alpha < 0.5f ? OnWall[Before] : OnWall[After];
+	return true;
+}
@@ -0,0 +1,216 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunJumpPrediction.h"
+#include "WallRun.h"
+#include "WallRunComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/GameplayStaticsTypes.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunPrediction, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("WallRun Jump Prediction"), STAT_WallRunJumpPrediction, STATGROUP_WallRun);
+
+
+// how far surface of the shape is from its center in the direction opposite to Normal
+static float ShapeExtentAlong(const FCollisionShape& Shape, const FVector& Normal)
+{
+	switch (Shape.ShapeType)
+	{
+	case ECollisionShape::Sphere:
+		return Shape.GetSphereRadius();
+	case ECollisionShape::Capsule:
+		return Shape.GetCapsuleRadius() + Shape.GetCapsuleAxisHalfLength() * FMath::Abs(Normal.Z);
+	case ECollisionShape::Box:
+		return FVector::DotProduct(Shape.GetExtent(), Normal.GetAbs());
+	default:
+		return 0.f;
+	}
+}
+
+FVector WallRunBallistics::Apex(const FVector& Start, const FVector& Velocity, float GravityZ)
+{
+	if (GravityZ >= 0.f || Velocity.Z <= 0.f)
+	{
+		return Start;
+	}
+	return PositionAt(Start, Velocity, GravityZ, -Velocity.Z / GravityZ);
+}
+
+bool WallRunBallistics::IntersectPlane(const FVector& Start, const FVector& Velocity, float GravityZ, const FPlane& Plane, float MinTime, float& OutTime)
+{
+	// signed distance to plane along the arc: A*t^2 + B*t + C
+	const float A = 0.5f * GravityZ * Plane.Z;
+	const float B = FVector::DotProduct(FVector(Plane), Velocity);
+	const float C = Plane.PlaneDot(Start);
+
+	// entering from the front side means distance goes down through zero
+	auto IsEntering = [A, B, MinTime](float Time) { return Time >= MinTime && B + 2.f * A * Time <= 0.f; };
+
+	if (FMath::IsNearlyZero(A))
+	{
+		if (FMath::IsNearlyZero(B))
+		{
+			return false;
+		}
+		OutTime = -C / B;
+		return IsEntering(OutTime);
+	}
+
+	const float Discriminant = B * B - 4.f * A * C;
+	if (Discriminant < 0.f)
+	{
+		return false;
+	}
+	const float SqrtDiscriminant = FMath::Sqrt(Discriminant);
+	float T0 = (-B - SqrtDiscriminant) / (2.f * A);
+	float T1 = (-B + SqrtDiscriminant) / (2.f * A);
+	if (T0 > T1)
+	{
+		Swap(T0, T1);
+	}
+	if (IsEntering(T0))
+	{
+		OutTime = T0;
+		return true;
+	}
+	if (IsEntering(T1))
+	{
+		OutTime = T1;
+		return true;
+	}
+	return false;
+}
+
+bool WallRunBallistics::PredictLanding(const UWorld* World, const FVector& Start, const FVector& Velocity, float GravityZ, const FCollisionShape& Shape,
+	ECollisionChannel Channel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, float MaxTime, float Tolerance,
+	FWallRunJumpPrediction& OutPrediction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WallRunJumpPrediction);
+
+	OutPrediction.LaunchVelocity = Velocity;
+	OutPrediction.Apex = Apex(Start, Velocity, GravityZ);
+	OutPrediction.bLands = false;
+
+	// chord of an arc segment of length dt is at most |g| * dt^2 / 8 away from it
+	const float Step = FMath::Clamp(FMath::Sqrt(8.f * Tolerance / FMath::Max(FMath::Abs(GravityZ), KINDA_SMALL_NUMBER)), 0.05f, FMath::Max(MaxTime, 0.05f));
+
+	// launching off a wall starts touching it, an initial overlap is not a landing
+	FCollisionQueryParams SweepParams(Params);
+	SweepParams.bFindInitialOverlaps = false;
+
+	float T0 = 0.f;
+	FVector P0 = Start;
+	while (T0 < MaxTime)
+	{
+		const float T1 = FMath::Min(T0 + Step, MaxTime);
+		const FVector P1 = PositionAt(Start, Velocity, GravityZ, T1);
+
+		FHitResult Hit;
+		if (World->SweepSingleByChannel(Hit, P0, P1, FQuat::Identity, Channel, Shape, SweepParams, ResponseParams) && !Hit.bStartPenetrating)
+		{
+			float Time = T0 + Hit.Time * (T1 - T0);
+
+			// chord only approximates the arc, solve exact contact with the hit surface offset by shape size
+			const FVector Normal = Hit.ImpactNormal;
+			const FPlane Plane(Hit.ImpactPoint + Normal * ShapeExtentAlong(Shape, Normal), Normal);
+			float ExactTime;
+			if (IntersectPlane(Start, Velocity, GravityZ, Plane, FMath::Max(T0 - Step, 0.f), ExactTime) && ExactTime <= T1 + Step)
+			{
+				Time = ExactTime;
+			}
+
+			OutPrediction.bLands = true;
+			OutPrediction.Time = Time;
+			OutPrediction.Location = PositionAt(Start, Velocity, GravityZ, Time);
+			OutPrediction.ImpactPoint = Hit.ImpactPoint;
+			OutPrediction.ImpactNormal = Normal;
+			return true;
+		}
+
+		T0 = T1;
+		P0 = P1;
+	}
+
+	OutPrediction.Time = MaxTime;
+	OutPrediction.Location = P0;
+	return false;
+}
+
+
+// times PredictWallJumps of the player's wallrun component (its capsule, channel and launch formula) and compares
+// landings with engine's stepped PredictProjectilePath for the same launch velocities
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkJumpPredictionCmd(
+	TEXT("WallRun.BenchmarkJumpPrediction"),
+	TEXT("Times wall jump landing prediction against PredictProjectilePath while the player is on a wall. Args: [NumCandidates]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 NumCandidates = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		constexpr float MaxTime = 2.f;
+		constexpr float SimFrequency = 30.f;
+
+		APlayerController* PC = World->GetFirstPlayerController();
+		ACharacter* Character = PC ? Cast<ACharacter>(PC->GetPawn()) : nullptr;
+		UWallRunComponent* WallRun = Character ? Character->FindComponentByClass<UWallRunComponent>() : nullptr;
+		if (!WallRun)
+		{
+			UE_LOG(LogWallRunPrediction, Warning, TEXT("Player has no wallrun component"));
+			return;
+		}
+
+		// movement inputs a wall jump can be made with
+		FRandomStream Random(1337);
+		TArray<FVector> InputVectors;
+		InputVectors.Reserve(NumCandidates);
+		for (int32 i = 0; i < NumCandidates; ++i)
+		{
+			const float Angle = Random.FRandRange(0.f, 2.f * PI);
+			InputVectors.Add(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f));
+		}
+
+		TArray<FWallRunJumpPrediction> Analytic;
+		const double AnalyticStart = FPlatformTime::Seconds();
+		WallRun->PredictWallJumps(InputVectors, Analytic, MaxTime);
+		const double AnalyticTime = FPlatformTime::Seconds() - AnalyticStart;
+		if (Analytic.Num() == 0)
+		{
+			UE_LOG(LogWallRunPrediction, Warning, TEXT("Player is not on a wall, wallrun and run the benchmark again"));
+			return;
+		}
+
+		// PredictProjectilePath sweeps a sphere only, capsule radius is the closest match
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		const FVector Start = Character->GetActorLocation();
+		const float GravityZ = WallRun->GetWallJumpGravityZ();
+		int32 NumCompared = 0;
+		float TotalError = 0.f;
+		const double SteppedStart = FPlatformTime::Seconds();
+		for (const FWallRunJumpPrediction& Prediction : Analytic)
+		{
+			FPredictProjectilePathParams PathParams(Capsule->GetScaledCapsuleRadius(), Start, Prediction.LaunchVelocity, MaxTime, Capsule->GetCollisionObjectType());
+			PathParams.SimFrequency = SimFrequency;
+			PathParams.OverrideGravityZ = GravityZ;
+			PathParams.ActorsToIgnore.Add(Character);
+			FPredictProjectilePathResult PathResult;
+			if (UGameplayStatics::PredictProjectilePath(World, PathParams, PathResult) && Prediction.bLands)
+			{
+				TotalError += FVector::Dist(PathResult.HitResult.Location, Prediction.Location);
+				++NumCompared;
+			}
+		}
+		const double SteppedTime = FPlatformTime::Seconds() - SteppedStart;
+
+		UE_LOG(LogWallRunPrediction, Display, TEXT("%d candidates: PredictWallJumps %.3f ms (%.2f us each), PredictProjectilePath @%.0f Hz %.3f ms (%.2f us each), mean landing difference %.1f cm over %d landings"),
+			NumCandidates, AnalyticTime * 1000.0, AnalyticTime * 1000000.0 / NumCandidates, SimFrequency, SteppedTime * 1000.0, SteppedTime * 1000000.0 / NumCandidates,
+			TotalError / FMath::Max(NumCompared, 1), NumCompared);
+	}));
@@ -0,0 +1,129 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunLagCompensationSubsystem.h"
+#include "WallRunCharacter.h"
+#include "WallRunHistory.h"
+#include "Components/CapsuleComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunLagComp, Log, All);
+
+
+void UWallRunLagCompensationSubsystem::RegisterCharacter(AWallRunCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UWallRunLagCompensationSubsystem::UnregisterCharacter(AWallRunCharacter* Character)
+{
+	Characters.RemoveSwap(Character);
+}
+
+float UWallRunLagCompensationSubsystem::ClampRewindTime(float Time) const
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	return FMath::Clamp(Time, Now - MaxRewindTime, Now);
+}
+
+// closest points of segment and capsule axis, true if they are within capsule radius
+static bool SegmentHitsCapsule(const FVector& Start, const FVector& End, const FWallRunHistorySample& Sample, float Radius, FVector& OutPointOnSegment)
+{
+	const FVector Up = Sample.Rotation.GetUpVector() * FMath::Max(Sample.CapsuleHalfHeight - Radius, 0.f);
+	FVector PointOnAxis;
+	FMath::SegmentDistToSegmentSafe(Start, End, Sample.Location - Up, Sample.Location + Up, OutPointOnSegment, PointOnAxis);
+	return FVector::DistSquared(OutPointOnSegment, PointOnAxis) <= FMath::Square(Radius);
+}
+
+bool UWallRunLagCompensationSubsystem::RewindLineTrace(const AActor* Shooter, const FVector& Start, const FVector& End, float Time, AWallRunCharacter*& OutHitCharacter, FVector& OutHitLocation) const
+{
+	OutHitCharacter = nullptr;
+	const float RewindTime = ClampRewindTime(Time);
+	float ClosestDistSquared = BIG_NUMBER;
+
+	for (AWallRunCharacter* Character : Characters)
+	{
+		if (!Character || Character == Shooter)
+		{
+			continue;
+		}
+		FWallRunHistorySample Sample;
+		if (!Character->GetHistory().Sample(RewindTime, Sample))
+		{
+			continue;
+		}
+		FVector PointOnSegment;
+		if (SegmentHitsCapsule(Start, End, Sample, Character->GetCapsuleComponent()->GetScaledCapsuleRadius(), PointOnSegment))
+		{
+			const float DistSquared = FVector::DistSquared(Start, PointOnSegment);
+			if (DistSquared < ClosestDistSquared)
+			{
+				ClosestDistSquared = DistSquared;
+				OutHitCharacter = Character;
+				OutHitLocation = PointOnSegment;
+			}
+		}
+	}
+	return OutHitCharacter != nullptr;
+}
+
+bool UWallRunLagCompensationSubsystem::ConfirmHit(const AWallRunCharacter* Target, const FVector& HitLocation, float Time, float Tolerance) const
+{
+	FWallRunHistorySample Sample;
+	if (!Target || !Target->GetHistory().Sample(ClampRewindTime(Time), Sample))
+	{
+		return false;
+	}
+	const float Radius = Target->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	const FVector Up = Sample.Rotation.GetUpVector() * FMath::Max(Sample.CapsuleHalfHeight - Radius, 0.f);
+	const FVector PointOnAxis = FMath::ClosestPointOnSegment(HitLocation, Sample.Location - Up, Sample.Location + Up);
+	return FVector::Dist(HitLocation, PointOnAxis) <= Radius + Tolerance;
+}
+
+// measures rewind cost for 100 characters with 1 second of history
+static FAutoConsoleCommand BenchmarkRewindCmd(
+	TEXT("WallRun.BenchmarkRewind"),
+	TEXT("Times lag compensation rewind queries for 100 characters x 1 s of history (120 Hz). Optional arg: number of queries"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		constexpr int32 NumCharacters = 100;
+		constexpr int32 SampleRate = 120;
+		const int32 NumQueries = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000;
+
+		FRandomStream Random(1337);
+		TArray<FWallRunHistory> Histories;
+		Histories.SetNum(NumCharacters);
+		for (FWallRunHistory& History : Histories)
+		{
+			History.Init(SampleRate);
+			FVector Location = Random.GetUnitVector() * 2000.f;
+			for (int32 i = 0; i < SampleRate; ++i)
+			{
+				Location += Random.GetUnitVector() * 10.f;
+				History.Record((float)i / SampleRate, Location, FQuat::Identity, 88.f, Random.FRand() > 0.5f);
+			}
+		}
+
+		int32 NumHits = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			// one rewound trace against every character, as RewindLineTrace does
+			const float Time = Random.FRand();
+			const FVector Start = Random.GetUnitVector() * 3000.f;
+			const FVector End = -Start;
+			for (const FWallRunHistory& History : Histories)
+			{
+				FWallRunHistorySample Sample;
+				FVector PointOnSegment;
+				if (History.Sample(Time, Sample) && SegmentHitsCapsule(Start, End, Sample, 55.f, PointOnSegment))
+				{
+					++NumHits;
+				}
+			}
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogWallRunLagComp, Display, TEXT("%d rewind traces x %d characters: %.3f ms total, %.3f us per trace (%d hits)"),
+			NumQueries, NumCharacters, Elapsed * 1000.0, Elapsed * 1000000.0 / FMath::Max(NumQueries, 1), NumHits);
+	}));
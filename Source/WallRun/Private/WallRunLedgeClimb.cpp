@@ -0,0 +1,85 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunLedgeClimb.h"
+#include "GameFramework/Character.h"
+
+const FName FRootMotionSource_WallRunLedgeClimb::InstanceNameDefault(TEXT("WallRunLedgeClimb"));
+
+
+FVector FRootMotionSource_WallRunLedgeClimb::GetLocationAt(float MoveFraction) const
+{
+	const FVector RiseTarget(StartLocation.X, StartLocation.Y, TargetLocation.Z);
+	const float Rise = FMath::Clamp(RiseFraction, KINDA_SMALL_NUMBER, 1.f);
+	if (MoveFraction < Rise)
+	{
+		return FMath::Lerp(StartLocation, RiseTarget, MoveFraction / Rise);
+	}
+	return FMath::Lerp(RiseTarget, TargetLocation, Rise < 1.f ? FMath::Clamp((MoveFraction - Rise) / (1.f - Rise), 0.f, 1.f) : 1.f);
+}
+
+FRootMotionSource* FRootMotionSource_WallRunLedgeClimb::Clone() const
+{
+	return new FRootMotionSource_WallRunLedgeClimb(*this);
+}
+
+bool FRootMotionSource_WallRunLedgeClimb::Matches(const FRootMotionSource* Other) const
+{
+	if (!FRootMotionSource_MoveToForce::Matches(Other))
+	{
+		return false;
+	}
+	// base checked that script structs match
+	const FRootMotionSource_WallRunLedgeClimb* OtherCast = static_cast<const FRootMotionSource_WallRunLedgeClimb*>(Other);
+	return FMath::IsNearlyEqual(RiseFraction, OtherCast->RiseFraction);
+}
+
+void FRootMotionSource_WallRunLedgeClimb::PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character, const UCharacterMovementComponent& MoveComponent)
+{
+	// same as move-to force, only the path differs
+	RootMotionParams.Clear();
+
+	if (Duration > SMALL_NUMBER && MovementTickTime > SMALL_NUMBER)
+	{
+		const float MoveFraction = (GetTime() + SimulationTime) / Duration;
+		const FVector CurrentTargetLocation = GetLocationAt(MoveFraction);
+		FVector Force = (CurrentTargetLocation - Character.GetActorLocation()) / MovementTickTime;
+
+		// after being blocked don't rush to catch up, move at the speed the path has
+		if (bRestrictSpeedToExpected && !Force.IsNearlyZero(KINDA_SMALL_NUMBER))
+		{
+			const FVector ExpectedLocation = GetLocationAt(GetTime() / Duration);
+			const float ExpectedSpeed = ((CurrentTargetLocation - ExpectedLocation) / MovementTickTime).Size();
+			if (Force.SizeSquared() > FMath::Square(ExpectedSpeed + 0.5f))
+			{
+				Force = Force.GetSafeNormal() * ExpectedSpeed;
+			}
+		}
+
+		RootMotionParams.Set(FTransform(Force));
+	}
+
+	SetTime(GetTime() + SimulationTime);
+}
+
+bool FRootMotionSource_WallRunLedgeClimb::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if (!FRootMotionSource_MoveToForce::NetSerialize(Ar, Map, bOutSuccess))
+	{
+		return false;
+	}
+	Ar << RiseFraction;
+	bOutSuccess = true;
+	return true;
+}
+
+UScriptStruct* FRootMotionSource_WallRunLedgeClimb::GetScriptStruct() const
+{
+	return FRootMotionSource_WallRunLedgeClimb::StaticStruct();
+}
+
+FString FRootMotionSource_WallRunLedgeClimb::ToSimpleString() const
+{
+	return FString::Printf(TEXT("[ID:%u]FRootMotionSource_WallRunLedgeClimb %s"), LocalID, *InstanceName.GetPlainNameString());
+}
@@ -0,0 +1,93 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRun.h"
+#include "WallRunCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunMemory, Log, All);
+
+
+// size of object itself plus resources it exclusively owns (mesh instances, buffers...)
+static SIZE_T GetObjectBytes(UObject* Object)
+{
+	FResourceSizeEx ResourceSize(EResourceSizeMode::Exclusive);
+	Object->GetResourceSizeEx(ResourceSize);
+	return Object->GetClass()->GetStructureSize() + ResourceSize.GetTotalMemoryBytes();
+}
+
+// spawns N player pawns (works on headless server: -nullrhi -ExecCmds="WallRun.MemReport 100")
+// and prints average bytes per character, broken down by component
+static FAutoConsoleCommandWithWorldAndArgs MemReportCmd(
+	TEXT("WallRun.MemReport"),
+	TEXT("Spawns N characters (default 50) and prints memory per character by component. Run with -LLM for WallRun LLM tags in 'stat LLM'"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 50;
+
+		UClass* PawnClass = AWallRunCharacter::StaticClass();
+		if (AGameModeBase* GameMode = World->GetAuthGameMode())
+		{
+			UClass* DefaultPawnClass = GameMode->GetDefaultPawnClassForController(nullptr);
+			if (DefaultPawnClass && DefaultPawnClass->IsChildOf(AWallRunCharacter::StaticClass()))
+			{
+				PawnClass = DefaultPawnClass;
+			}
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+		TArray<AWallRunCharacter*> Characters;
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			// far away from the level, spread so they don't collide with each other
+			const FVector Location(i * 200.f, 0.f, -100000.f);
+			LLM_SCOPE_BYTAG(WallRun_Characters);
+			if (AWallRunCharacter* Character = World->SpawnActor<AWallRunCharacter>(PawnClass, Location, FRotator::ZeroRotator, SpawnParams))
+			{
+				Characters.Add(Character);
+			}
+		}
+		const uint64 UsedAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+		TMap<FString, SIZE_T> BytesByComponent;
+		SIZE_T TotalBytes = 0;
+		for (AWallRunCharacter* Character : Characters)
+		{
+			const SIZE_T ActorBytes = GetObjectBytes(Character);
+			BytesByComponent.FindOrAdd(TEXT("(actor)")) += ActorBytes;
+			TotalBytes += ActorBytes;
+			TInlineComponentArray<UActorComponent*> Components(Character);
+			for (UActorComponent* Component : Components)
+			{
+				const SIZE_T ComponentBytes = GetObjectBytes(Component);
+				BytesByComponent.FindOrAdd(FString::Printf(TEXT("%s (%s)"), *Component->GetName(), *Component->GetClass()->GetName())) += ComponentBytes;
+				TotalBytes += ComponentBytes;
+			}
+		}
+
+		const int32 NumSpawned = FMath::Max(Characters.Num(), 1);
+		BytesByComponent.ValueSort([](SIZE_T A, SIZE_T B) { return A > B; });
+		UE_LOG(LogWallRunMemory, Display, TEXT("%d x %s"), Characters.Num(), *PawnClass->GetName());
+		for (const auto& Pair : BytesByComponent)
+		{
+			UE_LOG(LogWallRunMemory, Display, TEXT("  %-50s %8llu bytes"), *Pair.Key, (uint64)(Pair.Value / NumSpawned));
+		}
+		UE_LOG(LogWallRunMemory, Display, TEXT("  %-50s %8llu bytes"), TEXT("objects total"), (uint64)(TotalBytes / NumSpawned));
+		UE_LOG(LogWallRunMemory, Display, TEXT("  %-50s %8lld bytes"), TEXT("process memory delta"), ((int64)UsedAfter - (int64)UsedBefore) / NumSpawned);
+
+		for (AWallRunCharacter* Character : Characters)
+		{
+			Character->Destroy();
+		}
+	}));
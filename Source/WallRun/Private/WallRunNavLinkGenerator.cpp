@@ -0,0 +1,607 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunNavLinkGenerator.h"
+#include "WallRun.h"
+#include "WallRunCharacter.h"
+#include "WallRunComponent.h"
+#include "AI/NavigationSystemHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationSystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunNav, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("WallRun NavLinks Rebuild"), STAT_WallRunNavLinksRebuild, STATGROUP_WallRun);
+
+// longest fall simulated after leaving the wall
+static constexpr float MaxFallTime = 3.f;
+
+
+UWallRunNavArea_WallRun::UWallRunNavArea_WallRun()
+{
+	DefaultCost = 1.5f;
+	DrawColor = FColor(0, 200, 255);
+}
+
+UWallRunNavArea_WallJump::UWallRunNavArea_WallJump()
+{
+	DefaultCost = 2.f;
+	DrawColor = FColor(255, 120, 0);
+}
+
+UWallRunNavArea_WallRunSlow::UWallRunNavArea_WallRunSlow()
+{
+	DefaultCost = 3.f;
+	DrawColor = FColor(0, 100, 160);
+}
+
+UWallRunNavArea_WallJumpSlow::UWallRunNavArea_WallJumpSlow()
+{
+	DefaultCost = 4.f;
+	DrawColor = FColor(160, 70, 0);
+}
+
+
+AWallRunNavLinkGenerator::AWallRunNavLinkGenerator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	GenerationBox = CreateDefaultSubobject<UBoxComponent>(TEXT("GenerationBox"));
+	GenerationBox->SetBoxExtent(FVector(2000.f, 2000.f, 1000.f));
+	GenerationBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GenerationBox->SetCanEverAffectNavigation(false);
+	RootComponent = GenerationBox;
+
+	CellSize = 1000.f;
+	SampleSpacing = 150.f;
+	ProbeLength = 200.f;
+	NumProbeDirections = 8;
+	MinLinkLength = 300.f;
+	SimulationStep = 0.05f;
+	WallJumpSamples = 3;
+	WallRunArea = UWallRunNavArea_WallRun::StaticClass();
+	WallJumpArea = UWallRunNavArea_WallJump::StaticClass();
+	SlowLinkRatio = 2.f;
+	WallRunSlowArea = UWallRunNavArea_WallRunSlow::StaticClass();
+	WallJumpSlowArea = UWallRunNavArea_WallJumpSlow::StaticClass();
+	bRebuildOnGeometryChange = true;
+	LastRebuildTimeMs = 0.f;
+	LastRebuildCells = 0;
+	CellsBox = FBox(ForceInit);
+	CellsSize = 0.f;
+}
+
+void AWallRunNavLinkGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (Cells.Num() == 0)
+	{
+		Rebuild();
+	}
+}
+
+#if WITH_EDITOR
+void AWallRunNavLinkGenerator::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	if (GEngine && !ActorMovedHandle.IsValid() && !HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ActorMovedHandle = GEngine->OnActorMoved().AddUObject(this, &AWallRunNavLinkGenerator::OnActorMoved);
+	}
+}
+
+void AWallRunNavLinkGenerator::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// simulation settings changed, every cell is outdated
+	if (bRebuildOnGeometryChange)
+	{
+		RebuildAll();
+	}
+}
+
+void AWallRunNavLinkGenerator::BeginDestroy()
+{
+	if (GEngine && ActorMovedHandle.IsValid())
+	{
+		GEngine->OnActorMoved().Remove(ActorMovedHandle);
+		ActorMovedHandle.Reset();
+	}
+	Super::BeginDestroy();
+}
+
+void AWallRunNavLinkGenerator::OnActorMoved(AActor* Actor)
+{
+	UWorld* World = GetWorld();
+	if (!bRebuildOnGeometryChange || !Actor || !World || World->IsGameWorld() || Actor->GetWorld() != World)
+	{
+		return;
+	}
+
+	// generator itself moved - grid changed, otherwise only cells around moved geometry are regenerated
+	if (Actor == this || Actor->GetComponentsBoundingBox().Intersect(GenerationBox->Bounds.GetBox()))
+	{
+		Rebuild();
+	}
+}
+#endif
+
+bool AWallRunNavLinkGenerator::GetSimulationSettings(FSimulationSettings& OutSettings) const
+{
+	const AWallRunCharacter* Character = CharacterClass ? CharacterClass->GetDefaultObject<AWallRunCharacter>() : GetDefault<AWallRunCharacter>();
+	OutSettings.WallRun = Character ? Character->FindComponentByClass<UWallRunComponent>() : nullptr;
+	if (!OutSettings.WallRun || !GetWorld())
+	{
+		return false;
+	}
+
+	if (const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		OutSettings.RunSpeed = Movement->MaxWalkSpeed;
+		OutSettings.GravityScale = Movement->GravityScale;
+		OutSettings.WalkableFloorZ = Movement->GetWalkableFloorZ();
+	}
+	if (const UCapsuleComponent* Capsule = Character->GetCapsuleComponent())
+	{
+		OutSettings.CapsuleRadius = Capsule->GetUnscaledCapsuleRadius();
+		OutSettings.CapsuleHalfHeight = Capsule->GetUnscaledCapsuleHalfHeight();
+	}
+	OutSettings.WorldGravityZ = GetWorld()->GetGravityZ();
+
+	for (const TEnumAsByte<ECollisionChannel>& ObjectType : OutSettings.WallRun->ObjectTypesForWallRun)
+	{
+		OutSettings.ObjectParams.AddObjectTypesToQuery(ObjectType);
+	}
+	if (!OutSettings.ObjectParams.IsValid())
+	{
+		OutSettings.ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	}
+	OutSettings.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(WallRunNavLinks), false, this);
+	return true;
+}
+
+FBox AWallRunNavLinkGenerator::GetCellBox(const FIntPoint& Coord) const
+{
+	const FVector Min(CellsBox.Min.X + Coord.X * CellsSize, CellsBox.Min.Y + Coord.Y * CellsSize, CellsBox.Min.Z);
+	const FVector Max(FMath::Min(Min.X + CellsSize, CellsBox.Max.X), FMath::Min(Min.Y + CellsSize, CellsBox.Max.Y), CellsBox.Max.Z);
+	return FBox(Min, Max);
+}
+
+uint32 AWallRunNavLinkGenerator::HashCellGeometry(const FWallRunNavCell& Cell, const FSimulationSettings& Settings) const
+{
+	// geometry walls are searched in, plus every place existing links go through.
+	// new traversals can only start at walls of the cell, so this catches most changes that affect the cell
+	TArray<FBox, TInlineAllocator<16>> Boxes;
+	Boxes.Add(GetCellBox(Cell.Coord).ExpandBy(FVector(ProbeLength + Settings.CapsuleRadius, ProbeLength + Settings.CapsuleRadius, 0.f)));
+
+	// highest wall jump goes this much above the wall
+	const float JumpHeight = FMath::Square(Settings.WallRun->MaxWallJumpVelocity) / (2.f * FMath::Max(-Settings.WorldGravityZ * Settings.GravityScale, 1.f));
+	const FVector Up(0.f, 0.f, JumpHeight + Settings.CapsuleHalfHeight * 2.f);
+	for (const FWallRunNavLink& Link : Cell.Links)
+	{
+		const FVector Points[] = { Link.Start, Link.End, Link.Start + Up, Link.End + Up };
+		Boxes.Add(FBox(Points, UE_ARRAY_COUNT(Points)).ExpandBy(Settings.CapsuleRadius));
+	}
+
+	TArray<uint32> ComponentHashes;
+	TArray<FOverlapResult> Overlaps;
+	for (const FBox& Box : Boxes)
+	{
+		Overlaps.Reset();
+		GetWorld()->OverlapMultiByObjectType(Overlaps, Box.GetCenter(), FQuat::Identity, Settings.ObjectParams,
+			FCollisionShape::MakeBox(Box.GetExtent()), Settings.QueryParams);
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			const UPrimitiveComponent* Component = Overlap.GetComponent();
+			if (!Component)
+			{
+				continue;
+			}
+			// path is stable between editor sessions, bounds change with transform, mesh and instances
+			uint32 Hash = GetTypeHash(Component->GetPathName());
+			Hash = HashCombine(Hash, GetTypeHash(Component->Bounds.Origin));
+			Hash = HashCombine(Hash, GetTypeHash(Component->Bounds.BoxExtent));
+			Hash = HashCombine(Hash, GetTypeHash(Overlap.ItemIndex));
+			ComponentHashes.AddUnique(Hash);
+		}
+	}
+
+	// overlap order isn't stable
+	ComponentHashes.Sort();
+	uint32 Result = GetTypeHash(ComponentHashes.Num());
+	for (uint32 Hash : ComponentHashes)
+	{
+		Result = HashCombine(Result, Hash);
+	}
+	return Result;
+}
+
+int32 AWallRunNavLinkGenerator::Rebuild()
+{
+	SCOPE_CYCLE_COUNTER(STAT_WallRunNavLinksRebuild);
+	const double StartTime = FPlatformTime::Seconds();
+
+	FSimulationSettings Settings;
+	if (!GetSimulationSettings(Settings))
+	{
+		UE_LOG(LogWallRunNav, Warning, TEXT("%s: no UWallRunComponent on CharacterClass, links are not generated"), *GetName());
+		return 0;
+	}
+
+	// grid moved or resized, old cells don't match new ones
+	const FBox Box = GenerationBox->Bounds.GetBox();
+	if (!Box.Equals(CellsBox, 1.f) || CellsSize != CellSize)
+	{
+		Cells.Empty();
+		CellsBox = Box;
+		CellsSize = CellSize;
+	}
+
+	const int32 NumX = FMath::Max(FMath::CeilToInt(CellsBox.GetSize().X / CellsSize), 1);
+	const int32 NumY = FMath::Max(FMath::CeilToInt(CellsBox.GetSize().Y / CellsSize), 1);
+	if (Cells.Num() != NumX * NumY)
+	{
+		Cells.Reset(NumX * NumY);
+		for (int32 Y = 0; Y < NumY; ++Y)
+		{
+			for (int32 X = 0; X < NumX; ++X)
+			{
+				FWallRunNavCell& Cell = Cells.AddDefaulted_GetRef();
+				Cell.Coord = FIntPoint(X, Y);
+				// never matches a real hash, so the cell is generated
+				Cell.GeometryHash = 0;
+			}
+		}
+	}
+
+	int32 NumRebuilt = 0;
+	int32 NumLinks = 0;
+	for (FWallRunNavCell& Cell : Cells)
+	{
+		if (Cell.GeometryHash == 0 || HashCellGeometry(Cell, Settings) != Cell.GeometryHash)
+		{
+			GenerateCell(Cell, Settings);
+			// links are part of what the hash covers
+			Cell.GeometryHash = HashCellGeometry(Cell, Settings);
+			++NumRebuilt;
+		}
+		NumLinks += Cell.Links.Num();
+	}
+
+	if (NumRebuilt > 0)
+	{
+		UpdateNavigationLinks();
+	}
+
+	LastRebuildCells = NumRebuilt;
+	LastRebuildTimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	UE_LOG(LogWallRunNav, Log, TEXT("%s: regenerated %d of %d cells, %d links in %.2f ms"),
+		*GetName(), NumRebuilt, Cells.Num(), NumLinks, LastRebuildTimeMs);
+	return NumRebuilt;
+}
+
+void AWallRunNavLinkGenerator::RebuildAll()
+{
+	for (FWallRunNavCell& Cell : Cells)
+	{
+		Cell.GeometryHash = 0;
+	}
+	Rebuild();
+}
+
+void AWallRunNavLinkGenerator::GenerateCell(FWallRunNavCell& Cell, const FSimulationSettings& Settings) const
+{
+	Cell.Links.Reset();
+
+	UWorld* World = GetWorld();
+	const FBox Box = GetCellBox(Cell.Coord);
+
+	// walls already simulated from another sample of this cell
+	TArray<TPair<FVector, FVector>, TInlineAllocator<32>> Walls;
+
+	for (float X = Box.Min.X + SampleSpacing * 0.5f; X < Box.Max.X; X += SampleSpacing)
+	{
+		for (float Y = Box.Min.Y + SampleSpacing * 0.5f; Y < Box.Max.Y; Y += SampleSpacing)
+		{
+			FHitResult GroundHit;
+			if (!World->LineTraceSingleByObjectType(GroundHit, FVector(X, Y, Box.Max.Z), FVector(X, Y, Box.Min.Z), Settings.ObjectParams, Settings.QueryParams)
+				|| GroundHit.ImpactNormal.Z < Settings.WalkableFloorZ)
+			{
+				continue;
+			}
+
+			const FVector Ground = GroundHit.ImpactPoint;
+			// character center when standing on the ground sample
+			const FVector Probe = Ground + FVector(0.f, 0.f, Settings.CapsuleHalfHeight);
+
+			for (int32 DirIndex = 0; DirIndex < NumProbeDirections; ++DirIndex)
+			{
+				const float Angle = 2.f * PI * DirIndex / NumProbeDirections;
+				const FVector Dir(FMath::Cos(Angle), FMath::Sin(Angle), 0.f);
+
+				FHitResult WallHit;
+				if (!World->LineTraceSingleByObjectType(WallHit, Probe, Probe + Dir * ProbeLength, Settings.ObjectParams, Settings.QueryParams))
+				{
+					continue;
+				}
+				// same as wall check in UWallRunComponent::OnHit
+				if (FMath::RoundHalfFromZero(WallHit.ImpactNormal.Z) != 0.f)
+				{
+					continue;
+				}
+
+				const FVector Normal = WallHit.ImpactNormal.GetSafeNormal2D();
+				const bool bKnownWall = Walls.ContainsByPredicate([&](const TPair<FVector, FVector>& Wall)
+				{
+					return FVector::DistSquared(Wall.Key, WallHit.ImpactPoint) < FMath::Square(SampleSpacing) && (Wall.Value | Normal) > 0.95f;
+				});
+				if (bKnownWall)
+				{
+					continue;
+				}
+				Walls.Emplace(WallHit.ImpactPoint, Normal);
+
+				const FVector Contact = WallHit.ImpactPoint + Normal * Settings.CapsuleRadius;
+				SimulateWallRun(Ground, Contact, Normal, 1.f, Settings, Cell.Links);
+				SimulateWallRun(Ground, Contact, Normal, -1.f, Settings, Cell.Links);
+			}
+		}
+	}
+}
+
+void AWallRunNavLinkGenerator::SimulateWallRun(const FVector& Ground, const FVector& Contact, const FVector& InWallNormal, float Side,
+	const FSimulationSettings& Settings, TArray<FWallRunNavLink>& OutLinks) const
+{
+	const UWallRunComponent* WallRun = Settings.WallRun;
+	UWorld* World = GetWorld();
+	const FVector FeetOffset(0.f, 0.f, Settings.CapsuleHalfHeight);
+	const float MinWallDot = FMath::Cos(FMath::DegreesToRadians(WallRun->SameWallAngle));
+
+	FVector Normal = InWallNormal;
+	FVector WallDirection = FVector::CrossProduct(FVector::UpVector, Normal) * Side;
+
+	// character runs at the wall at 45 degrees and keeps pushing in that direction
+	const FVector InputVector = (WallDirection - Normal).GetSafeNormal();
+	const FQuat Rotation = InputVector.ToOrientationQuat();
+	FWallRunKinematics Kinematics;
+	Kinematics.Update(Rotation, InputVector * Settings.RunSpeed, Normal, FVector::CrossProduct(FVector::UpVector, Normal));
+	FVector Velocity = WallRun->CalculateStickLaunchVelocity(Normal, Kinematics, InputVector);
+	// wall blocks the part of launch going into it
+	Velocity -= Normal * FMath::Min(FVector::DotProduct(Velocity, Normal), 0.f);
+
+	const float OnWallGravityZ = Settings.WorldGravityZ * WallRun->OnWallGravity;
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(WallRun->WallRunDuration / SimulationStep), 1);
+	const int32 JumpEvery = FMath::Max(NumSteps / WallJumpSamples, 1);
+
+	FVector Location = Contact;
+	float Time = 0.f;
+	float LostTime = 0.f;
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		if (Step % JumpEvery == 0)
+		{
+			// jump away from the wall, forward along it
+			const FVector JumpInput = (WallDirection + Normal).GetSafeNormal();
+			FVector Landing;
+			float FallTime;
+			Kinematics.Update(Rotation, Velocity, Normal, FVector::CrossProduct(FVector::UpVector, Normal));
+			if (SimulateFall(Location, WallRun->CalculateWallJumpVelocity(Normal, Kinematics, JumpInput), Settings, Landing, FallTime))
+			{
+				AddLink(EWallRunTraversal::WallJump, Ground, Landing, Normal, Time + FallTime, Settings, OutLinks);
+			}
+		}
+
+		const FVector Next = Location + Velocity * SimulationStep;
+		Velocity.Z += OnWallGravityZ * SimulationStep;
+		Time += SimulationStep;
+
+		FHitResult Hit;
+		if (World->LineTraceSingleByObjectType(Hit, Location - FeetOffset, Next - FeetOffset, Settings.ObjectParams, Settings.QueryParams))
+		{
+			// ran down to the ground or into something - wallrun ends there
+			if (Hit.ImpactNormal.Z >= Settings.WalkableFloorZ)
+			{
+				AddLink(EWallRunTraversal::WallRun, Ground, Hit.ImpactPoint, InWallNormal, Time, Settings, OutLinks);
+			}
+			return;
+		}
+		Location = Next;
+
+		// same wall trace as UWallRunComponent tick
+		FHitResult WallHit;
+		const FVector TraceEnd = Location - Normal * (Settings.CapsuleRadius + WallRun->WallTraceLength);
+		if (World->LineTraceSingleByObjectType(WallHit, Location, TraceEnd, Settings.ObjectParams, Settings.QueryParams)
+			&& (WallHit.ImpactNormal.GetSafeNormal2D() | Normal) >= MinWallDot)
+		{
+			LostTime = 0.f;
+			Normal = WallHit.ImpactNormal.GetSafeNormal2D();
+			WallDirection = FVector::CrossProduct(FVector::UpVector, Normal) * Side;
+		}
+		else
+		{
+			LostTime += SimulationStep;
+			if (LostTime > WallRun->WallLostGraceTime)
+			{
+				break;
+			}
+		}
+	}
+
+	// off the wall (timeout or wall end), OffWall keeps velocity
+	FVector Landing;
+	float FallTime;
+	if (SimulateFall(Location, Velocity, Settings, Landing, FallTime))
+	{
+		AddLink(EWallRunTraversal::WallRun, Ground, Landing, InWallNormal, Time + FallTime, Settings, OutLinks);
+	}
+}
+
+bool AWallRunNavLinkGenerator::SimulateFall(FVector Location, FVector Velocity, const FSimulationSettings& Settings, FVector& OutLanding, float& OutTime) const
+{
+	UWorld* World = GetWorld();
+	const FVector FeetOffset(0.f, 0.f, Settings.CapsuleHalfHeight);
+	const float GravityZ = Settings.WorldGravityZ * Settings.GravityScale;
+
+	// air control is ignored, so links only need the launch itself
+	for (OutTime = 0.f; OutTime < MaxFallTime; OutTime += SimulationStep)
+	{
+		const FVector Next = Location + Velocity * SimulationStep;
+		Velocity.Z += GravityZ * SimulationStep;
+
+		FHitResult Hit;
+		if (World->LineTraceSingleByObjectType(Hit, Location - FeetOffset, Next - FeetOffset, Settings.ObjectParams, Settings.QueryParams))
+		{
+			OutLanding = Hit.ImpactPoint;
+			return Hit.ImpactNormal.Z >= Settings.WalkableFloorZ;
+		}
+		Location = Next;
+	}
+	return false;
+}
+
+void AWallRunNavLinkGenerator::AddLink(EWallRunTraversal Type, const FVector& Start, const FVector& End, const FVector& InWallNormal, float Duration,
+	const FSimulationSettings& Settings, TArray<FWallRunNavLink>& OutLinks) const
+{
+	if (FVector::DistSquared(Start, End) < FMath::Square(MinLinkLength))
+	{
+		return;
+	}
+
+	FVector NavStart = Start;
+	FVector NavEnd = End;
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys && NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate))
+	{
+		const FVector Extent(Settings.CapsuleRadius * 2.f, Settings.CapsuleRadius * 2.f, Settings.CapsuleHalfHeight);
+		FNavLocation StartLocation;
+		FNavLocation EndLocation;
+		if (!NavSys->ProjectPointToNavigation(Start, StartLocation, Extent) || !NavSys->ProjectPointToNavigation(End, EndLocation, Extent))
+		{
+			return;
+		}
+		NavStart = StartLocation.Location;
+		NavEnd = EndLocation.Location;
+	}
+
+	// neighbouring samples find nearly the same traversals
+	const float MergeDistanceSquared = FMath::Square(SampleSpacing);
+	for (const FWallRunNavLink& Link : OutLinks)
+	{
+		if (Link.Type == Type && FVector::DistSquared(Link.Start, NavStart) < MergeDistanceSquared && FVector::DistSquared(Link.End, NavEnd) < MergeDistanceSquared)
+		{
+			return;
+		}
+	}
+
+	FWallRunNavLink& Link = OutLinks.AddDefaulted_GetRef();
+	Link.Type = Type;
+	Link.Start = NavStart;
+	Link.End = NavEnd;
+	Link.WallNormal = InWallNormal;
+	Link.Duration = Duration;
+	Link.Cost = Duration * Settings.RunSpeed;
+}
+
+void AWallRunNavLinkGenerator::UpdateNavigationLinks()
+{
+	PointLinks.Reset();
+	const FTransform& ActorTransform = GetActorTransform();
+	for (const FWallRunNavCell& Cell : Cells)
+	{
+		for (const FWallRunNavLink& Link : Cell.Links)
+		{
+			// nav links are in actor space
+			FNavigationLink& NavLink = PointLinks.Emplace_GetRef(ActorTransform.InverseTransformPosition(Link.Start),
+				ActorTransform.InverseTransformPosition(Link.End), ENavLinkDirection::LeftToRight);
+			// recast prices links by straight line length only, long traversals between close points go to slow areas
+			const bool bSlow = Link.GetCostRatio() > SlowLinkRatio;
+			if (Link.Type == EWallRunTraversal::WallJump)
+			{
+				NavLink.SetAreaClass(bSlow && WallJumpSlowArea ? *WallJumpSlowArea : *WallJumpArea);
+			}
+			else
+			{
+				NavLink.SetAreaClass(bSlow && WallRunSlowArea ? *WallRunSlowArea : *WallRunArea);
+			}
+		}
+	}
+
+	FNavigationSystem::UpdateActorData(*this);
+}
+
+void AWallRunNavLinkGenerator::GetLinks(TArray<FWallRunNavLink>& OutLinks) const
+{
+	for (const FWallRunNavCell& Cell : Cells)
+	{
+		OutLinks.Append(Cell.Links);
+	}
+}
+
+bool AWallRunNavLinkGenerator::GetNavigationLinksClasses(TArray<TSubclassOf<UNavLinkDefinition>>& OutClasses) const
+{
+	return false;
+}
+
+bool AWallRunNavLinkGenerator::GetNavigationLinksArray(TArray<FNavigationLink>& OutLink, TArray<FNavigationSegmentLink>& OutSegments) const
+{
+	OutLink.Append(PointLinks);
+	return PointLinks.Num() > 0;
+}
+
+void AWallRunNavLinkGenerator::GetNavigationData(FNavigationRelevantData& Data) const
+{
+	NavigationHelper::ProcessNavLinkAndAppend(&Data.Modifiers, this, PointLinks);
+}
+
+FBox AWallRunNavLinkGenerator::GetNavigationBounds() const
+{
+	FBox Box(ForceInit);
+	for (const FWallRunNavCell& Cell : Cells)
+	{
+		for (const FWallRunNavLink& Link : Cell.Links)
+		{
+			Box += Link.Start;
+			Box += Link.End;
+		}
+	}
+	return Box.IsValid ? Box.ExpandBy(100.f) : GetComponentsBoundingBox();
+}
+
+bool AWallRunNavLinkGenerator::IsNavigationRelevant() const
+{
+	return PointLinks.Num() > 0;
+}
+
+// rebuild links of all generators, e.g. after WallRun.GenerateCourse
+static FAutoConsoleCommandWithWorldAndArgs RebuildNavLinksCmd(
+	TEXT("WallRun.RebuildNavLinks"),
+	TEXT("Regenerates wallrun nav links where geometry changed. Args: [full]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const bool bFull = Args.Num() > 0 && Args[0] == TEXT("full");
+		for (TActorIterator<AWallRunNavLinkGenerator> It(World); It; ++It)
+		{
+			if (bFull)
+			{
+				It->RebuildAll();
+			}
+			else
+			{
+				It->Rebuild();
+			}
+		}
+	}));
@@ -0,0 +1,582 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunNetBenchmarkSubsystem.h"
+#include "WallRunCharacter.h"
+#include "WallRunComponent.h"
+#include "WallRunCourseGenerator.h"
+#include "WallCharacterMovementComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunNetBenchmark, Log, All);
+
+// id events of the pawn carry, 0 if it has no wallrun component
+static uint32 GetCharacterId(const APawn* Pawn)
+{
+	const UWallRunComponent* WallRun = Pawn ? Pawn->FindComponentByClass<UWallRunComponent>() : nullptr;
+	return WallRun ? WallRun->GetCharacterId() : 0;
+}
+
+UWallRunNetBenchmarkSubsystem::UWallRunNetBenchmarkSubsystem()
+{
+	SettleTime = 3.f;
+	ProfileTime = 20.f;
+}
+
+void UWallRunNetBenchmarkSubsystem::Deinitialize()
+{
+	if (IsRunning())
+	{
+		UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("Net benchmark interrupted by world teardown"));
+		Finish();
+	}
+	Super::Deinitialize();
+}
+
+bool UWallRunNetBenchmarkSubsystem::StartBenchmark(const TArray<FName>& ProfileNames, float InProfileTime, int32 NumClients, const FString& Label, bool bInExitWhenDone)
+{
+	UWorld* World = GetWorld();
+	UNetDriver* Driver = World ? World->GetNetDriver() : nullptr;
+	if (!Driver || !Driver->IsServer())
+	{
+		UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("Net benchmark needs a running server"));
+		return false;
+	}
+	if (IsRunning())
+	{
+		UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("Net benchmark is already running"));
+		return false;
+	}
+#if !DO_ENABLE_NET_TEST
+	UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("Net emulation is compiled out of this build, profiles will run without lag and loss"));
+#endif
+
+	RunProfiles.Reset();
+	for (const FWallRunNetProfile& Profile : Profiles)
+	{
+		if (ProfileNames.Num() == 0 || ProfileNames.Contains(Profile.Name))
+		{
+			RunProfiles.Add(Profile);
+		}
+	}
+	if (RunProfiles.Num() == 0)
+	{
+		UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("No matching net profiles, check [/Script/WallRun.WallRunNetBenchmarkSubsystem] in DefaultGame.ini"));
+		return false;
+	}
+
+	NetDriver = Driver;
+#if DO_ENABLE_NET_TEST
+	SavedSettings = MakeShared<FPacketSimulationSettings>(Driver->PacketSimulationSettings);
+#endif
+	ProfileIndex = 0;
+	Stage = EStage::WaitForClients;
+	StageTime = 0.f;
+	RunProfileTime = InProfileTime > 0.f ? InProfileTime : ProfileTime;
+	RequiredClients = FMath::Max(NumClients, 1);
+	RunLabel = Label;
+	bExitWhenDone = bInExitWhenDone;
+	Csv = TEXT("Label,Profile,LagMs,JitterMs,LossPct,Client,Seconds,Moves,Corrections,CorrectionsPerSec,MeanErrorCm,MaxErrorCm,OutBytesPerSec,InBytesPerSec,Sticks,WallJumps,Climbs\n");
+
+	if (UWallRunEventBus* EventBus = World->GetSubsystem<UWallRunEventBus>())
+	{
+		EventsHandle = EventBus->OnEvents.AddUObject(this, &UWallRunNetBenchmarkSubsystem::OnEvents);
+	}
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UWallRunNetBenchmarkSubsystem::Tick));
+
+	UE_LOG(LogWallRunNetBenchmark, Display, TEXT("Net benchmark: %d profiles, %.1f s each, waiting for %d clients"), RunProfiles.Num(), RunProfileTime, RequiredClients);
+	return true;
+}
+
+bool UWallRunNetBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	if (!NetDriver.IsValid())
+	{
+		Finish();
+		return false;
+	}
+
+	StageTime += DeltaTime;
+	switch (Stage)
+	{
+	case EStage::WaitForClients:
+		if (GetNumReadyClients() >= RequiredClients)
+		{
+			PlacePawns();
+			ApplyProfile(RunProfiles[ProfileIndex]);
+			Stage = EStage::Settle;
+			StageTime = 0.f;
+		}
+		break;
+
+	case EStage::Settle:
+		if (StageTime >= SettleTime)
+		{
+			BeginMeasure();
+			Stage = EStage::Measure;
+			StageTime = 0.f;
+		}
+		break;
+
+	case EStage::Measure:
+		if (StageTime >= RunProfileTime)
+		{
+			EndMeasure();
+			if (++ProfileIndex >= RunProfiles.Num())
+			{
+				Finish();
+				return false;
+			}
+			ApplyProfile(RunProfiles[ProfileIndex]);
+			Stage = EStage::Settle;
+			StageTime = 0.f;
+		}
+		break;
+	}
+	return true;
+}
+
+void UWallRunNetBenchmarkSubsystem::ApplyProfile(const FWallRunNetProfile& Profile)
+{
+	UE_LOG(LogWallRunNetBenchmark, Display, TEXT("Net profile %s: %d ms rtt, +-%d ms jitter, %d%% loss"), *Profile.Name.ToString(), Profile.Lag, Profile.Jitter, Profile.Loss);
+#if DO_ENABLE_NET_TEST
+	// server side emulation delays and drops in both directions, clients don't need any settings
+	const int32 OneWayLag = Profile.Lag / 2;
+	FPacketSimulationSettings Settings;
+	Settings.PktLagMin = FMath::Max(OneWayLag - Profile.Jitter, 0);
+	Settings.PktLagMax = OneWayLag + Profile.Jitter;
+	Settings.PktLoss = Profile.Loss;
+	Settings.PktIncomingLagMin = Settings.PktLagMin;
+	Settings.PktIncomingLagMax = Settings.PktLagMax;
+	Settings.PktIncomingLoss = Profile.Loss;
+	NetDriver->SetPacketSimulationSettings(Settings);
+#endif
+}
+
+void UWallRunNetBenchmarkSubsystem::PlacePawns()
+{
+	TActorIterator<AWallRunCourseGenerator> Course(GetWorld());
+	if (!Course || Course->SpawnPoints.Num() == 0)
+	{
+		return;
+	}
+
+	// one client per spawn point, so clients don't collide and every one runs the same kind of course
+	int32 SpawnIndex = 0;
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		APlayerController* PC = Connection ? Connection->PlayerController : nullptr;
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+		const FTransform Spawn = Course->SpawnPoints[SpawnIndex++ % Course->SpawnPoints.Num()] * Course->GetActorTransform();
+		Pawn->TeleportTo(Spawn.GetLocation(), Spawn.Rotator());
+		PC->ClientSetRotation(Spawn.Rotator());
+	}
+}
+
+void UWallRunNetBenchmarkSubsystem::BeginMeasure()
+{
+	Samples.Reset();
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		APlayerController* PC = Connection ? Connection->PlayerController : nullptr;
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+		if (UWallCharacterMovementComponent* MoveComp = Cast<UWallCharacterMovementComponent>(Pawn->GetMovementComponent()))
+		{
+			MoveComp->ResetNetStats();
+		}
+
+		FClientSample& Sample = Samples.AddDefaulted_GetRef();
+		Sample.Connection = Connection;
+		Sample.CharacterId = GetCharacterId(Pawn);
+		Sample.StartOutBytes = Connection->OutTotalBytes;
+		Sample.StartInBytes = Connection->InTotalBytes;
+	}
+}
+
+void UWallRunNetBenchmarkSubsystem::EndMeasure()
+{
+	const FWallRunNetProfile& Profile = RunProfiles[ProfileIndex];
+	const float Seconds = FMath::Max(StageTime, KINDA_SMALL_NUMBER);
+
+	int32 TotalCorrections = 0;
+	float MaxError = 0.f;
+	for (int32 Index = 0; Index < Samples.Num(); ++Index)
+	{
+		const FClientSample& Sample = Samples[Index];
+		UNetConnection* Connection = Sample.Connection.Get();
+		APawn* Pawn = Connection && Connection->PlayerController ? Connection->PlayerController->GetPawn() : nullptr;
+		const UWallCharacterMovementComponent* MoveComp = Pawn ? Cast<UWallCharacterMovementComponent>(Pawn->GetMovementComponent()) : nullptr;
+		if (!Connection || !MoveComp || GetCharacterId(Pawn) != Sample.CharacterId)
+		{
+			// disconnected or respawned while measuring
+			continue;
+		}
+
+		const FWallRunNetMoveStats& Stats = MoveComp->NetStats;
+		const float MeanError = Stats.NumMoves > 0 ? (float)(Stats.ErrorSum / Stats.NumMoves) : 0.f;
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d,%d,%d,%.2f,%d,%d,%.3f,%.3f,%.3f,%.1f,%.1f,%d,%d,%d\n"),
+			*RunLabel, *Profile.Name.ToString(), Profile.Lag, Profile.Jitter, Profile.Loss, Index, Seconds,
+			Stats.NumMoves, Stats.NumCorrections, Stats.NumCorrections / Seconds, MeanError, Stats.MaxError,
+			(Connection->OutTotalBytes - Sample.StartOutBytes) / Seconds, (Connection->InTotalBytes - Sample.StartInBytes) / Seconds,
+			Sample.NumSticks, Sample.NumJumps, Sample.NumClimbs);
+
+		TotalCorrections += Stats.NumCorrections;
+		MaxError = FMath::Max(MaxError, Stats.MaxError);
+	}
+
+	UE_LOG(LogWallRunNetBenchmark, Display, TEXT("  %s: %d clients, %.2f corrections/s per client, max error %.1f cm"),
+		*Profile.Name.ToString(), Samples.Num(), Samples.Num() > 0 ? TotalCorrections / Seconds / Samples.Num() : 0.f, MaxError);
+	Samples.Reset();
+}
+
+void UWallRunNetBenchmarkSubsystem::Finish()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	if (UWallRunEventBus* EventBus = GetWorld() ? GetWorld()->GetSubsystem<UWallRunEventBus>() : nullptr)
+	{
+		EventBus->OnEvents.Remove(EventsHandle);
+	}
+	EventsHandle.Reset();
+
+#if DO_ENABLE_NET_TEST
+	if (UNetDriver* Driver = NetDriver.Get())
+	{
+		if (SavedSettings.IsValid())
+		{
+			Driver->SetPacketSimulationSettings(*SavedSettings);
+		}
+	}
+#endif
+	SavedSettings.Reset();
+	NetDriver.Reset();
+
+	const FString FileName = FPaths::ProfilingDir() / TEXT("WallRun") / FString::Printf(TEXT("WallRunNet-%s.csv"), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		UE_LOG(LogWallRunNetBenchmark, Display, TEXT("Net benchmark results written to %s"), *FileName);
+	}
+	else
+	{
+		UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("Failed to write %s"), *FileName);
+	}
+	Csv.Empty();
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UWallRunNetBenchmarkSubsystem::OnEvents(TArrayView<const FWallRunEvent> Events)
+{
+	if (Stage != EStage::Measure)
+	{
+		return;
+	}
+	for (const FWallRunEvent& Event : Events)
+	{
+		FClientSample* Sample = Samples.FindByPredicate([&Event](const FClientSample& It) { return It.CharacterId == Event.CharacterId; });
+		if (!Sample)
+		{
+			continue;
+		}
+		switch (Event.Type)
+		{
+		case EWallRunEventType::Stick: ++Sample->NumSticks; break;
+		case EWallRunEventType::Jump: ++Sample->NumJumps; break;
+		case EWallRunEventType::Climb: ++Sample->NumClimbs; break;
+		default: break;
+		}
+	}
+}
+
+int32 UWallRunNetBenchmarkSubsystem::GetNumReadyClients() const
+{
+	int32 NumReady = 0;
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection && Connection->PlayerController && Connection->PlayerController->GetPawn())
+		{
+			++NumReady;
+		}
+	}
+	return NumReady;
+}
+
+
+// scripted input for locally controlled characters of every game world in this process (PIE clients or a -game client):
+// run along the course, jump, steer into the wall, wallrun, wall jump to the opposite wall and so on.
+// walls of generated course end with ledges, so climbs happen on their own. turns around when it keeps running on the floor
+class FWallRunNetBenchmarkBot
+{
+public:
+	static FWallRunNetBenchmarkBot& Get()
+	{
+		static FWallRunNetBenchmarkBot Bot;
+		return Bot;
+	}
+
+	void SetEnabled(bool bEnabled)
+	{
+		if (bEnabled && !TickerHandle.IsValid())
+		{
+			TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FWallRunNetBenchmarkBot::Tick));
+		}
+		else if (!bEnabled && TickerHandle.IsValid())
+		{
+			FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+			TickerHandle.Reset();
+			States.Empty();
+		}
+	}
+
+private:
+	enum class EPhase : uint8
+	{
+		Run,
+		Approach,
+		WallRun,
+	};
+
+	struct FState
+	{
+		FVector Forward = FVector::ForwardVector;
+		FVector LastLocation = FVector::ZeroVector;
+		// side of the wall to steer to, 1 - right
+		float Side = 1.f;
+		float PhaseTime = 0.f;
+		float FloorTime = 0.f;
+		EPhase Phase = EPhase::Run;
+		bool bJumpHeld = false;
+		bool bInitialized = false;
+	};
+
+	// seconds of running before the first jump
+	static constexpr float RunTime = 0.4f;
+	// seconds without a wall before trying the other side
+	static constexpr float ApproachTime = 1.2f;
+	// seconds on wall before wall jump
+	static constexpr float WallRunTime = 0.6f;
+	// seconds on floor before turning around (course end or fell off)
+	static constexpr float TurnAroundTime = 2.f;
+	// moved further than this in one frame - teleported, start over
+	static constexpr float TeleportDistance = 1000.f;
+
+	TMap<TWeakObjectPtr<AWallRunCharacter>, FState> States;
+
+	FDelegateHandle TickerHandle;
+
+	bool Tick(float DeltaTime)
+	{
+		if (!GEngine)
+		{
+			return true;
+		}
+		for (auto It = States.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (!World || !World->IsGameWorld() || World->GetNetMode() == NM_DedicatedServer)
+			{
+				continue;
+			}
+			for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+			{
+				APlayerController* PC = It->Get();
+				AWallRunCharacter* Character = PC && PC->IsLocalController() ? Cast<AWallRunCharacter>(PC->GetPawn()) : nullptr;
+				if (Character)
+				{
+					Drive(PC, Character, States.FindOrAdd(Character), DeltaTime);
+				}
+			}
+		}
+		return true;
+	}
+
+	void Drive(APlayerController* PC, AWallRunCharacter* Character, FState& State, float DeltaTime)
+	{
+		const UWallRunComponent* WallRunComp = Character->FindComponentByClass<UWallRunComponent>();
+		const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+		if (!WallRunComp || !MoveComp)
+		{
+			return;
+		}
+
+		const FVector Location = Character->GetActorLocation();
+		if (!State.bInitialized || FVector::DistSquared(Location, State.LastLocation) > FMath::Square(TeleportDistance))
+		{
+			// along the generated course if there is one, else wherever the character looks
+			TActorIterator<AWallRunCourseGenerator> Course(Character->GetWorld());
+			State = FState();
+			State.Forward = Course ? Course->GetActorForwardVector().GetSafeNormal2D() : Character->GetActorForwardVector().GetSafeNormal2D();
+			State.bInitialized = true;
+		}
+		State.LastLocation = Location;
+		State.PhaseTime += DeltaTime;
+
+		// jump is pressed for one frame
+		if (State.bJumpHeld)
+		{
+			Character->StopJumping();
+			State.bJumpHeld = false;
+		}
+
+		const FVector Right(-State.Forward.Y, State.Forward.X, 0.f);
+		const bool bFalling = MoveComp->IsFalling();
+		State.FloorTime = (bFalling || WallRunComp->bOnWall) ? 0.f : State.FloorTime + DeltaTime;
+		if (State.FloorTime > TurnAroundTime)
+		{
+			State.Forward = -State.Forward;
+			State.FloorTime = 0.f;
+			SetPhase(State, EPhase::Run);
+		}
+
+		FVector Input = State.Forward;
+		switch (State.Phase)
+		{
+		case EPhase::Run:
+			if (!bFalling && State.PhaseTime > RunTime)
+			{
+				PressJump(Character, State);
+				SetPhase(State, EPhase::Approach);
+			}
+			break;
+
+		case EPhase::Approach:
+			Input += Right * State.Side * 0.7f;
+			if (WallRunComp->bOnWall)
+			{
+				SetPhase(State, EPhase::WallRun);
+			}
+			else if (State.PhaseTime > ApproachTime)
+			{
+				// no wall on this side
+				State.Side = -State.Side;
+				SetPhase(State, EPhase::Run);
+			}
+			break;
+
+		case EPhase::WallRun:
+			if (!WallRunComp->bOnWall)
+			{
+				// wall ended, climbed or timed out - look for the next one on the same side
+				SetPhase(State, EPhase::Approach);
+			}
+			else if (State.PhaseTime > WallRunTime)
+			{
+				PressJump(Character, State);
+				State.Side = -State.Side;
+				SetPhase(State, EPhase::Approach);
+			}
+			break;
+		}
+
+		PC->SetControlRotation(State.Forward.Rotation());
+		Character->AddMovementInput(Input.GetSafeNormal2D(), 1.f);
+	}
+
+	static void SetPhase(FState& State, EPhase Phase)
+	{
+		State.Phase = Phase;
+		State.PhaseTime = 0.f;
+	}
+
+	static void PressJump(AWallRunCharacter* Character, FState& State)
+	{
+		Character->Jump();
+		State.bJumpHeld = true;
+	}
+};
+
+
+// course has to exist the same on server and clients: use a map with the course placed, or run WallRun.GenerateCourse
+// on server (PIE: from any window), its generator replicates and every client builds the same walls from its seed.
+// then WallRun.NetBenchmarkBot 1 on clients (in PIE it drives all of them) and this command on server
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkNetConditionsCmd(
+	TEXT("WallRun.BenchmarkNetConditions"),
+	TEXT("WallRun.BenchmarkNetConditions [SecondsPerProfile] [Profile...] [-clients=N] [-label=Name] [-exit]. Server only: measures wallrun prediction under every net profile, writes Saved/Profiling/WallRun/WallRunNet-*.csv"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!GEngine)
+		{
+			return;
+		}
+		// in PIE the command may come from a client world, use the server one
+		UWorld* ServerWorld = nullptr;
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* ContextWorld = Context.World();
+			if (ContextWorld && ContextWorld->IsGameWorld() && ContextWorld->GetNetDriver() && ContextWorld->GetNetDriver()->IsServer())
+			{
+				ServerWorld = ContextWorld;
+				break;
+			}
+		}
+		UWallRunNetBenchmarkSubsystem* Subsystem = ServerWorld ? ServerWorld->GetSubsystem<UWallRunNetBenchmarkSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			UE_LOG(LogWallRunNetBenchmark, Warning, TEXT("WallRun.BenchmarkNetConditions needs a running server"));
+			return;
+		}
+
+		float Seconds = 0.f;
+		int32 NumClients = 1;
+		FString Label = TEXT("default");
+		bool bExit = false;
+		TArray<FName> ProfileNames;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.StartsWith(TEXT("-")))
+			{
+				FParse::Value(*Arg, TEXT("-clients="), NumClients);
+				FParse::Value(*Arg, TEXT("-label="), Label);
+				bExit |= Arg.Equals(TEXT("-exit"), ESearchCase::IgnoreCase);
+			}
+			else if (Arg.IsNumeric())
+			{
+				Seconds = FCString::Atof(*Arg);
+			}
+			else
+			{
+				ProfileNames.Add(FName(*Arg));
+			}
+		}
+		Subsystem->StartBenchmark(ProfileNames, Seconds, NumClients, Label, bExit);
+	}));
+
+static FAutoConsoleCommand NetBenchmarkBotCmd(
+	TEXT("WallRun.NetBenchmarkBot"),
+	TEXT("WallRun.NetBenchmarkBot [1|0]. Scripted wallrun, wall jump and ledge climb input for local players, see WallRun.BenchmarkNetConditions"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const bool bEnabled = Args.Num() == 0 || FCString::Atoi(*Args[0]) != 0;
+		FWallRunNetBenchmarkBot::Get().SetEnabled(bEnabled);
+		UE_LOG(LogWallRunNetBenchmark, Display, TEXT("Net benchmark bot %s"), bEnabled ? TEXT("enabled") : TEXT("disabled"));
+	}));
@@ -0,0 +1,195 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunPawnPoolSubsystem.h"
+#include "WallRun.h"
+#include "WallRunCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunPool, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Characters"), STAT_WallRunPooledCharacters, STATGROUP_WallRun);
+DECLARE_CYCLE_STAT(TEXT("WallRun Pool Acquire"), STAT_WallRunPoolAcquire, STATGROUP_WallRun);
+
+
+void UWallRunPawnPoolSubsystem::Deinitialize()
+{
+	Pooled.Empty();
+	Super::Deinitialize();
+}
+
+AWallRunCharacter* UWallRunPawnPoolSubsystem::SpawnCharacter(UClass* CharacterClass, const FTransform& SpawnTransform)
+{
+	LLM_SCOPE_BYTAG(WallRun_Characters);
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	AWallRunCharacter* Character = GetWorld()->SpawnActor<AWallRunCharacter>(CharacterClass, SpawnTransform, SpawnParams);
+	if (Character)
+	{
+		Character->bPooled = true;
+	}
+	return Character;
+}
+
+AWallRunCharacter* UWallRunPawnPoolSubsystem::AcquireCharacter(UClass* CharacterClass, const FTransform& SpawnTransform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WallRunPoolAcquire);
+
+	const int32 Index = Pooled.FindLastByPredicate([CharacterClass](const AWallRunCharacter* Character)
+	{
+		return Character && !Character->IsPendingKill() && Character->GetClass() == CharacterClass;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return SpawnCharacter(CharacterClass, SpawnTransform);
+	}
+
+	AWallRunCharacter* Character = Pooled[Index];
+	Pooled.RemoveAtSwap(Index);
+	SET_DWORD_STAT(STAT_WallRunPooledCharacters, Pooled.Num());
+	Character->OnAcquiredFromPool(SpawnTransform);
+	return Character;
+}
+
+void UWallRunPawnPoolSubsystem::ReleaseCharacter(AWallRunCharacter* Character)
+{
+	if (!Character || Character->IsPendingKill())
+	{
+		return;
+	}
+	if (AController* Controller = Character->GetController())
+	{
+		Controller->UnPossess();
+	}
+
+	// only characters created by the pool are reused, others are destroyed as before
+	if (!bEnabled || !Character->bPooled || Pooled.Num() >= MaxPooled)
+	{
+		Character->Destroy();
+		return;
+	}
+	Character->OnReleasedToPool();
+	Pooled.Add(Character);
+	SET_DWORD_STAT(STAT_WallRunPooledCharacters, Pooled.Num());
+}
+
+void UWallRunPawnPoolSubsystem::Prewarm(UClass* CharacterClass, int32 Count)
+{
+	if (!bEnabled || !CharacterClass || !CharacterClass->IsChildOf(AWallRunCharacter::StaticClass()))
+	{
+		return;
+	}
+	const double StartTime = FPlatformTime::Seconds();
+	// far below the level, they are hidden right away
+	const FTransform SpawnTransform(FVector(0.f, 0.f, -100000.f));
+	int32 NumSpawned = 0;
+	for (int32 i = 0; i < Count && Pooled.Num() < MaxPooled; ++i)
+	{
+		if (AWallRunCharacter* Character = SpawnCharacter(CharacterClass, SpawnTransform))
+		{
+			ReleaseCharacter(Character);
+			++NumSpawned;
+		}
+	}
+	UE_LOG(LogWallRunPool, Log, TEXT("Prewarmed %d x %s in %.2f ms"), NumSpawned, *CharacterClass->GetName(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+
+// spawn/despawn N characters with and without the pool, then GC with N live characters of each kind
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkRespawnCmd(
+	TEXT("WallRun.BenchmarkRespawn"),
+	TEXT("Measures character respawn cost and GC time with and without pawn pool. Args: [NumCharacters]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UWallRunPawnPoolSubsystem* Pool = World ? World->GetSubsystem<UWallRunPawnPoolSubsystem>() : nullptr;
+		if (!Pool)
+		{
+			return;
+		}
+		const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 32;
+
+		UClass* PawnClass = AWallRunCharacter::StaticClass();
+		if (AGameModeBase* GameMode = World->GetAuthGameMode())
+		{
+			UClass* DefaultPawnClass = GameMode->GetDefaultPawnClassForController(nullptr);
+			if (DefaultPawnClass && DefaultPawnClass->IsChildOf(AWallRunCharacter::StaticClass()))
+			{
+				PawnClass = DefaultPawnClass;
+			}
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		auto SpawnTransform = [](int32 i) { return FTransform(FVector(i * 200.f, 0.f, -100000.f)); };
+		auto TimeGC = []()
+		{
+			const double Start = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			return (FPlatformTime::Seconds() - Start) * 1000.0;
+		};
+
+		// baseline - spawn, GC with them alive, destroy
+		TArray<AWallRunCharacter*> Characters;
+		double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			LLM_SCOPE_BYTAG(WallRun_Characters);
+			Characters.Add(World->SpawnActor<AWallRunCharacter>(PawnClass, SpawnTransform(i), SpawnParams));
+		}
+		const double SpawnMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+		const double SpawnGCMs = TimeGC();
+		Start = FPlatformTime::Seconds();
+		for (AWallRunCharacter* Character : Characters)
+		{
+			if (Character)
+			{
+				Character->Destroy();
+			}
+		}
+		const double DestroyMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+		Characters.Reset();
+		TimeGC();
+
+		// pool - first pass fills it, second pass is what respawn costs
+		const bool bWasEnabled = Pool->bEnabled;
+		const int32 OldMaxPooled = Pool->MaxPooled;
+		Pool->bEnabled = true;
+		Pool->MaxPooled = FMath::Max(OldMaxPooled, Pool->GetNumPooled() + NumCharacters);
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			Characters.Add(Pool->AcquireCharacter(PawnClass, SpawnTransform(i)));
+		}
+		for (AWallRunCharacter* Character : Characters)
+		{
+			Pool->ReleaseCharacter(Character);
+		}
+		Characters.Reset();
+
+		Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumCharacters; ++i)
+		{
+			Characters.Add(Pool->AcquireCharacter(PawnClass, SpawnTransform(i)));
+		}
+		const double AcquireMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+		const double PoolGCMs = TimeGC();
+		Start = FPlatformTime::Seconds();
+		for (AWallRunCharacter* Character : Characters)
+		{
+			Pool->ReleaseCharacter(Character);
+		}
+		const double ReleaseMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+		Pool->bEnabled = bWasEnabled;
+		Pool->MaxPooled = OldMaxPooled;
+
+		UE_LOG(LogWallRunPool, Display, TEXT("%d x %s"), NumCharacters, *PawnClass->GetName());
+		UE_LOG(LogWallRunPool, Display, TEXT("  spawn   %.3f ms/character, destroy %.3f ms/character, GC with them alive %.2f ms"),
+			SpawnMs / NumCharacters, DestroyMs / NumCharacters, SpawnGCMs);
+		UE_LOG(LogWallRunPool, Display, TEXT("  acquire %.3f ms/character, release %.3f ms/character, GC with them alive %.2f ms"),
+			AcquireMs / NumCharacters, ReleaseMs / NumCharacters, PoolGCMs);
+	}));
@@ -0,0 +1,135 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunPerfCounters.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunPerf, Log, All);
+
+bool FWallRunPerfCounters::bOverlayEnabled = false;
+bool FWallRunPerfCounters::bCapturing = false;
+int32 FWallRunPerfCounters::LiveProjectiles = 0;
+FWallRunPerfFrame FWallRunPerfCounters::CurrentFrame;
+FWallRunPerfFrame FWallRunPerfCounters::History[FWallRunPerfCounters::HistorySize];
+int32 FWallRunPerfCounters::NextFrame = 0;
+int32 FWallRunPerfCounters::NumFrames = 0;
+float FWallRunPerfCounters::CaptureTimeLeft = 0.f;
+TArray<FWallRunPerfFrame> FWallRunPerfCounters::CaptureFrames;
+
+static int32 GWallRunPerfOverlay = 0;
+
+struct FWallRunPerfOverlayCVar
+{
+	static void OnChanged(IConsoleVariable* Var)
+	{
+		FWallRunPerfCounters::bOverlayEnabled = GWallRunPerfOverlay != 0;
+		FWallRunPerfCounters::EnsureEndFrameHook();
+		// don't show frames counted before it was turned off
+		FWallRunPerfCounters::NumFrames = 0;
+		FWallRunPerfCounters::CurrentFrame = FWallRunPerfFrame();
+	}
+};
+
+static FAutoConsoleVariableRef CVarWallRunPerfOverlay(
+	TEXT("wallrun.PerfOverlay"),
+	GWallRunPerfOverlay,
+	TEXT("Shows wallrun performance overlay on HUD: tick time, traces, hits, stick/unstick per frame, live projectiles"),
+	FConsoleVariableDelegate::CreateStatic(&FWallRunPerfOverlayCVar::OnChanged),
+	ECVF_Cheat);
+
+
+void FWallRunPerfCounters::EnsureEndFrameHook()
+{
+	static bool bHooked = false;
+	if (!bHooked)
+	{
+		bHooked = true;
+		FCoreDelegates::OnEndFrame.AddStatic(&FWallRunPerfCounters::EndFrame);
+	}
+}
+
+void FWallRunPerfCounters::EndFrame()
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+	const float DeltaTime = FApp::GetDeltaTime();
+	CurrentFrame.FrameTimeMs = DeltaTime * 1000.f;
+	CurrentFrame.NumProjectiles = LiveProjectiles;
+
+	History[NextFrame] = CurrentFrame;
+	NextFrame = (NextFrame + 1) % HistorySize;
+	NumFrames = FMath::Min(NumFrames + 1, HistorySize);
+
+	if (bCapturing)
+	{
+		CaptureFrames.Add(CurrentFrame);
+		CaptureTimeLeft -= DeltaTime;
+		if (CaptureTimeLeft <= 0.f)
+		{
+			WriteCapture();
+		}
+	}
+
+	CurrentFrame = FWallRunPerfFrame();
+}
+
+const FWallRunPerfFrame& FWallRunPerfCounters::GetFrame(int32 Age)
+{
+	check(Age >= 0 && Age < HistorySize);
+	return History[(NextFrame - 1 - Age + HistorySize) % HistorySize];
+}
+
+void FWallRunPerfCounters::StartCapture(float Seconds)
+{
+	if (bCapturing)
+	{
+		WriteCapture();
+	}
+	CaptureFrames.Reset();
+	CaptureFrames.Reserve(FMath::CeilToInt(Seconds * 120.f));
+	CaptureTimeLeft = Seconds;
+	CurrentFrame = FWallRunPerfFrame();
+	bCapturing = true;
+	EnsureEndFrameHook();
+	UE_LOG(LogWallRunPerf, Log, TEXT("Capturing wallrun counters for %.1f s"), Seconds);
+}
+
+void FWallRunPerfCounters::WriteCapture()
+{
+	bCapturing = false;
+
+	FString Csv = TEXT("Frame,FrameTimeMs,WallRunTickMs,Traces,Hits,Sticks,Unsticks,Projectiles\n");
+	for (int32 Index = 0; Index < CaptureFrames.Num(); ++Index)
+	{
+		const FWallRunPerfFrame& Frame = CaptureFrames[Index];
+		Csv += FString::Printf(TEXT("%d,%.3f,%.4f,%d,%d,%d,%d,%d\n"), Index, Frame.FrameTimeMs, Frame.WallRunTickMs,
+			Frame.NumTraces, Frame.NumHits, Frame.NumSticks, Frame.NumUnsticks, Frame.NumProjectiles);
+	}
+
+	const FString FileName = FPaths::ProfilingDir() / TEXT("WallRun") / FString::Printf(TEXT("WallRunPerf-%s.csv"), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		UE_LOG(LogWallRunPerf, Display, TEXT("Wrote %d frames to %s"), CaptureFrames.Num(), *FileName);
+	}
+	else
+	{
+		UE_LOG(LogWallRunPerf, Warning, TEXT("Failed to write %s"), *FileName);
+	}
+	CaptureFrames.Empty();
+}
+
+static FAutoConsoleCommand PerfCaptureCmd(
+	TEXT("WallRun.PerfCapture"),
+	TEXT("Records wallrun per-frame counters for N seconds (default 10) and writes them to Saved/Profiling/WallRun/*.csv"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FWallRunPerfCounters::StartCapture(Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 0.1f) : 10.f);
+	}));
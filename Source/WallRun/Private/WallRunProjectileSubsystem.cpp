@@ -0,0 +1,308 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunProjectileSubsystem.h"
+#include "WallRun.h"
+#include "WallRunCharacter.h"
+#include "WallRunLagCompensationSubsystem.h"
+#include "WallRunProjectile.h"
+#include "Containers/Ticker.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunProjectiles, Log, All);
+
+static TAutoConsoleVariable<int32> CVarWallRunProjectileReplication(
+	TEXT("wallrun.ProjectileReplication"),
+	1,
+	TEXT("How shots are replicated:\n")
+	TEXT(" 0: server spawns one replicated actor per projectile\n")
+	TEXT(" 1: server multicasts a fire event, every machine simulates projectile locally, server sends impact corrections"),
+	ECVF_Default);
+
+
+void FWallRunFireEvent::Quantize()
+{
+	// matches SerializePackedVector<10, 24> and FRotator::SerializeCompressedShort
+	Origin = FVector(FMath::RoundToInt(Origin.X * 10.f), FMath::RoundToInt(Origin.Y * 10.f), FMath::RoundToInt(Origin.Z * 10.f)) / 10.f;
+	Rotation = FRotator(
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Pitch)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Yaw)),
+		FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Roll)));
+}
+
+bool FWallRunFireEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// ~12 bytes: packed origin, pitch and yaw shorts (zero roll is one bit), time, seed
+	bOutSuccess = SerializePackedVector<10, 24>(Origin, Ar);
+	Rotation.SerializeCompressedShort(Ar);
+	Ar << Timestamp;
+	Ar << Seed;
+	return true;
+}
+
+
+bool UWallRunProjectileSubsystem::UseFireEvents()
+{
+	return CVarWallRunProjectileReplication.GetValueOnGameThread() != 0;
+}
+
+float UWallRunProjectileSubsystem::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+FWallRunFireEvent UWallRunProjectileSubsystem::MakeFireEvent(const FVector& Origin, const FRotator& Rotation, uint16 Seed) const
+{
+	FWallRunFireEvent Event;
+	Event.Origin = Origin;
+	Event.Rotation = Rotation;
+	Event.Timestamp = GetServerTime();
+	Event.Seed = Seed;
+	Event.Quantize();
+	return Event;
+}
+
+uint64 UWallRunProjectileSubsystem::MakeShotKey(const AActor* Shooter, uint16 Seed)
+{
+	return ((uint64)Shooter->GetUniqueID() << 16) | Seed;
+}
+
+AWallRunProjectile* UWallRunProjectileSubsystem::SpawnProjectile(AWallRunCharacter* Shooter, UClass* ProjectileClass, const FWallRunFireEvent& Event, bool bAuthoritative, bool bReplicated, bool bCatchUp)
+{
+	if (!Shooter || !ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	// same cone on every machine for the same seed
+	FRotator Rotation = Event.Rotation;
+	if (SpreadAngle > 0.f)
+	{
+		const FRandomStream Stream(Event.Seed);
+		Rotation = Stream.VRandCone(Rotation.Vector(), FMath::DegreesToRadians(SpreadAngle)).Rotation();
+	}
+	const FTransform SpawnTransform(Rotation, Event.Origin);
+
+	LLM_SCOPE_BYTAG(WallRun_Projectiles);
+	AWallRunProjectile* Projectile = GetWorld()->SpawnActorDeferred<AWallRunProjectile>(ProjectileClass, SpawnTransform, Shooter, Shooter, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding);
+	if (!Projectile)
+	{
+		return nullptr;
+	}
+	Projectile->ShotSeed = Event.Seed;
+	Projectile->bAuthoritative = bAuthoritative;
+	Projectile->ShotTime = Event.Timestamp;
+	if (bAuthoritative && GetWorld()->GetNetMode() != NM_Standalone)
+	{
+		// remote shooter sees others about a round trip late (their moves to server, server state back)
+		const APlayerState* PlayerState = Shooter->GetPlayerState();
+		Projectile->bLagCompensated = true;
+		Projectile->ViewDelay = !Shooter->IsLocallyControlled() && PlayerState ? PlayerState->ExactPing * 0.001f : 0.f;
+	}
+	Projectile->SetReplicates(bReplicated);
+	Projectile->SetReplicateMovement(bReplicated);
+	Projectile->FinishSpawning(SpawnTransform);
+	if (Projectile->IsPendingKill())
+	{
+		return nullptr;
+	}
+
+	if (bCatchUp)
+	{
+		const float Age = FMath::Clamp(GetServerTime() - Event.Timestamp, 0.f, MaxCatchUpTime);
+		Projectile->CatchUp(Age, CatchUpStep);
+	}
+
+	if (!bReplicated && !Projectile->IsPendingKill())
+	{
+		Projectiles.Add(MakeShotKey(Shooter, Event.Seed), Projectile);
+	}
+	++NumShots;
+	return Projectile;
+}
+
+void UWallRunProjectileSubsystem::OnProjectileImpact(AWallRunProjectile* Projectile, const FHitResult& Hit)
+{
+	AWallRunCharacter* Shooter = Cast<AWallRunCharacter>(Projectile->GetInstigator());
+	if (!Shooter || !Projectile->bAuthoritative || Projectile->GetIsReplicated() || GetWorld()->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	FWallRunProjectileImpact Impact;
+	Impact.Seed = Projectile->ShotSeed;
+	Impact.Location = Projectile->GetActorLocation();
+	Impact.Normal = Hit.ImpactNormal;
+	Shooter->MulticastProjectileImpact(Impact);
+	++NumImpacts;
+}
+
+bool UWallRunProjectileSubsystem::TraceRewound(AWallRunProjectile* Projectile, const FVector& Start, const FVector& End)
+{
+	AWallRunCharacter* Shooter = Cast<AWallRunCharacter>(Projectile->GetInstigator());
+	const UWallRunLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UWallRunLagCompensationSubsystem>();
+	if (!Shooter || !LagCompensation || Start.Equals(End))
+	{
+		return false;
+	}
+
+	AWallRunCharacter* Target = nullptr;
+	FVector HitLocation;
+	if (!LagCompensation->RewindLineTrace(Shooter, Start, End, Projectile->GetShooterViewTime(), Target, HitLocation))
+	{
+		return false;
+	}
+
+	UE_LOG(LogWallRunProjectiles, Verbose, TEXT("%s shot %u hit %s rewound %.3f s"), *Shooter->GetName(), Projectile->ShotSeed, *Target->GetName(),
+		GetWorld()->GetTimeSeconds() - Projectile->GetShooterViewTime());
+	++NumCharacterHits;
+	OnCharacterHit.Broadcast(Shooter, Target, HitLocation);
+
+	// clients' copies stop where the shooter saw the hit
+	Projectile->SetActorLocation(HitLocation);
+	FHitResult Hit;
+	Hit.ImpactPoint = HitLocation;
+	Hit.ImpactNormal = (Start - End).GetSafeNormal();
+	OnProjectileImpact(Projectile, Hit);
+	Projectile->Destroy();
+	return true;
+}
+
+void UWallRunProjectileSubsystem::ApplyImpact(const AWallRunCharacter* Shooter, const FWallRunProjectileImpact& Impact)
+{
+	TWeakObjectPtr<AWallRunProjectile> Projectile;
+	if (!Shooter || !Projectiles.RemoveAndCopyValue(MakeShotKey(Shooter, Impact.Seed), Projectile) || !Projectile.IsValid())
+	{
+		// local one already hit something on its own
+		return;
+	}
+
+	UE_LOG(LogWallRunProjectiles, Verbose, TEXT("%s shot %u corrected by %.1f"), *Shooter->GetName(), Impact.Seed, FVector::Dist(Projectile->GetActorLocation(), Impact.Location));
+	Projectile->SetActorLocation(Impact.Location);
+	Projectile->Destroy();
+}
+
+void UWallRunProjectileSubsystem::OnProjectileEndPlay(AWallRunProjectile* Projectile)
+{
+	if (const AActor* Shooter = Projectile->GetInstigator())
+	{
+		const uint64 Key = MakeShotKey(Shooter, Projectile->ShotSeed);
+		if (const TWeakObjectPtr<AWallRunProjectile>* Found = Projectiles.Find(Key))
+		{
+			if (Found->Get() == Projectile)
+			{
+				Projectiles.Remove(Key);
+			}
+		}
+	}
+}
+
+
+// headless comparison of both replication paths, on a server with clients connected:
+//   server: -server -nullrhi -log -ExecCmds="wallrun.ProjectileReplication 0, WallRun.BenchmarkProjectileNet 10 10"
+//   clients: 127.0.0.1 -game -nullrhi -nosound -windowed (several instances)
+// every server side character fires ShotsPerSecond for Seconds, then outgoing bytes and open channels are printed
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkProjectileNetCmd(
+	TEXT("WallRun.BenchmarkProjectileNet"),
+	TEXT("WallRun.BenchmarkProjectileNet [Seconds=10] [ShotsPerSecond=10]. Server only: every character fires, prints outgoing bandwidth and peak channel count for current wallrun.ProjectileReplication"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver || !NetDriver->IsServer())
+		{
+			UE_LOG(LogWallRunProjectiles, Warning, TEXT("WallRun.BenchmarkProjectileNet needs a running server"));
+			return;
+		}
+		UWallRunProjectileSubsystem* Subsystem = World->GetSubsystem<UWallRunProjectileSubsystem>();
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		const float Duration = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.f) : 10.f;
+		const float ShotsPerSecond = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 0.1f) : 10.f;
+
+		struct FBenchmarkState
+		{
+			TWeakObjectPtr<UWorld> World;
+			TWeakObjectPtr<UNetDriver> NetDriver;
+			TWeakObjectPtr<UWallRunProjectileSubsystem> Subsystem;
+			float Elapsed = 0.f;
+			float FireAccumulator = 0.f;
+			uint32 StartBytes = 0;
+			int32 StartShots = 0;
+			int32 StartImpacts = 0;
+			int32 PeakChannels = 0;
+			int32 PeakActorChannels = 0;
+		};
+		TSharedRef<FBenchmarkState> State = MakeShared<FBenchmarkState>();
+		State->World = World;
+		State->NetDriver = NetDriver;
+		State->Subsystem = Subsystem;
+		State->StartBytes = NetDriver->OutTotalBytes;
+		State->StartShots = Subsystem->NumShots;
+		State->StartImpacts = Subsystem->NumImpacts;
+
+		const bool bFireEvents = UWallRunProjectileSubsystem::UseFireEvents();
+		UE_LOG(LogWallRunProjectiles, Display, TEXT("Projectile net benchmark: %s, %d clients, %.1f s at %.1f shots/s per character"),
+			bFireEvents ? TEXT("fire events") : TEXT("replicated actors"), NetDriver->ClientConnections.Num(), Duration, ShotsPerSecond);
+
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([State, Duration, ShotsPerSecond, bFireEvents](float DeltaTime)
+		{
+			UWorld* World = State->World.Get();
+			UNetDriver* NetDriver = State->NetDriver.Get();
+			UWallRunProjectileSubsystem* Subsystem = State->Subsystem.Get();
+			if (!World || !NetDriver || !Subsystem)
+			{
+				return false;
+			}
+
+			State->Elapsed += DeltaTime;
+			State->FireAccumulator += DeltaTime * ShotsPerSecond;
+			while (State->FireAccumulator >= 1.f)
+			{
+				State->FireAccumulator -= 1.f;
+				for (TActorIterator<AWallRunCharacter> It(World); It; ++It)
+				{
+					if (!It->bInPool)
+					{
+						It->AuthorityFire();
+					}
+				}
+			}
+
+			int32 Channels = 0;
+			int32 ActorChannels = 0;
+			for (UNetConnection* Connection : NetDriver->ClientConnections)
+			{
+				Channels += Connection->OpenChannels.Num();
+				ActorChannels += Connection->ActorChannelsNum();
+			}
+			State->PeakChannels = FMath::Max(State->PeakChannels, Channels);
+			State->PeakActorChannels = FMath::Max(State->PeakActorChannels, ActorChannels);
+
+			if (State->Elapsed < Duration)
+			{
+				return true;
+			}
+
+			const uint32 Bytes = NetDriver->OutTotalBytes - State->StartBytes;
+			const int32 Shots = Subsystem->NumShots - State->StartShots;
+			const int32 NumClients = FMath::Max(NetDriver->ClientConnections.Num(), 1);
+			UE_LOG(LogWallRunProjectiles, Display, TEXT("Projectile net benchmark (%s) results:"), bFireEvents ? TEXT("fire events") : TEXT("replicated actors"));
+			UE_LOG(LogWallRunProjectiles, Display, TEXT("  shots %d, impact corrections %d"), Shots, Subsystem->NumImpacts - State->StartImpacts);
+			UE_LOG(LogWallRunProjectiles, Display, TEXT("  out %.1f KB/s total, %.1f KB/s per client, %.1f bytes per shot per client"),
+				Bytes / 1024.f / State->Elapsed, Bytes / 1024.f / State->Elapsed / NumClients, Shots > 0 ? (float)Bytes / Shots / NumClients : 0.f);
+			UE_LOG(LogWallRunProjectiles, Display, TEXT("  peak open channels %d (actor channels %d) over %d clients"), State->PeakChannels, State->PeakActorChannels, NumClients);
+			return false;
+		}));
+	}));
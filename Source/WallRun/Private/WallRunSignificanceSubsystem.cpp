@@ -0,0 +1,170 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunSignificanceSubsystem.h"
+#include "WallRun.h"
+#include "WallRunCharacter.h"
+#include "WallRunComponent.h"
+#include "WallRunAudioSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Tier 0"), STAT_WallRunTier0, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Tier 1"), STAT_WallRunTier1, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Tier 2"), STAT_WallRunTier2, STATGROUP_WallRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Tier 3+"), STAT_WallRunTier3, STATGROUP_WallRun);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Wallrun Ticks Saved Per Second"), STAT_WallRunTicksSaved, STATGROUP_WallRun);
+
+
+void FWallRunSignificanceTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->Update();
+	}
+}
+
+void UWallRunSignificanceSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	Characters.Empty();
+	CharacterTiers.Empty();
+	Super::Deinitialize();
+}
+
+void UWallRunSignificanceSubsystem::RegisterCharacter(AWallRunCharacter* Character)
+{
+	if (Characters.Contains(Character))
+	{
+		return;
+	}
+	Characters.Add(Character);
+	CharacterTiers.Add(0);
+
+	// significance only matters where someone looks at the characters
+	UWorld* World = GetWorld();
+	if (!TickFunction.IsTickFunctionRegistered() && World && World->PersistentLevel && World->GetNetMode() != NM_DedicatedServer)
+	{
+		TickFunction.Subsystem = this;
+		TickFunction.bCanEverTick = true;
+		TickFunction.TickGroup = TG_PrePhysics;
+		TickFunction.TickInterval = UpdateInterval;
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+}
+
+void UWallRunSignificanceSubsystem::UnregisterCharacter(AWallRunCharacter* Character)
+{
+	const int32 Index = Characters.Find(Character);
+	if (Index != INDEX_NONE)
+	{
+		Characters.RemoveAtSwap(Index);
+		CharacterTiers.RemoveAtSwap(Index);
+	}
+}
+
+int32 UWallRunSignificanceSubsystem::GetTier(const AWallRunCharacter* Character) const
+{
+	const int32 Index = Characters.IndexOfByKey(Character);
+	return Index != INDEX_NONE ? CharacterTiers[Index] : 0;
+}
+
+void UWallRunSignificanceSubsystem::Update()
+{
+	UWorld* World = GetWorld();
+	if (!World || Tiers.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> Viewpoints;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PC->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Add(Location);
+		}
+	}
+
+	int32 TierCounts[4] = { 0, 0, 0, 0 };
+	const float FrameRate = 1.f / FMath::Max(World->GetDeltaSeconds(), KINDA_SMALL_NUMBER);
+	float TicksSaved = 0.f;
+
+	for (int32 Index = 0; Index < Characters.Num(); ++Index)
+	{
+		AWallRunCharacter* Character = Characters[Index];
+		if (!Character)
+		{
+			continue;
+		}
+
+		int32 Tier = 0;
+		if (Character->GetLocalRole() == ROLE_SimulatedProxy)
+		{
+			float ClosestDistSquared = BIG_NUMBER;
+			for (const FVector& Viewpoint : Viewpoints)
+			{
+				ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(Viewpoint, Character->GetActorLocation()));
+			}
+			while (Tier < Tiers.Num() - 1 && ClosestDistSquared > FMath::Square(Tiers[Tier].MaxDistance))
+			{
+				++Tier;
+			}
+			if (bUseVisibility && !Character->WasRecentlyRendered(0.5f))
+			{
+				Tier = FMath::Min(Tier + 1, Tiers.Num() - 1);
+			}
+		}
+
+		if (Tier != CharacterTiers[Index])
+		{
+			CharacterTiers[Index] = Tier;
+			ApplyTier(Character, Tier);
+		}
+
+		++TierCounts[FMath::Min(Tier, 3)];
+		if (Tiers[Tier].TickInterval > 0.f)
+		{
+			TicksSaved += FMath::Max(FrameRate - 1.f / Tiers[Tier].TickInterval, 0.f);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_WallRunTier0, TierCounts[0]);
+	SET_DWORD_STAT(STAT_WallRunTier1, TierCounts[1]);
+	SET_DWORD_STAT(STAT_WallRunTier2, TierCounts[2]);
+	SET_DWORD_STAT(STAT_WallRunTier3, TierCounts[3]);
+	SET_FLOAT_STAT(STAT_WallRunTicksSaved, TicksSaved);
+
+	// runners moved in and out of hearing range since their loop started
+	if (UWallRunAudioSubsystem* AudioSubsystem = World->GetSubsystem<UWallRunAudioSubsystem>())
+	{
+		AudioSubsystem->UpdateLoops();
+	}
+}
+
+void UWallRunSignificanceSubsystem::ApplyTier(AWallRunCharacter* Character, int32 Tier)
+{
+	const FWallRunSignificanceTier& Settings = Tiers[Tier];
+	if (UWallRunComponent* WallRunComp = Character->FindComponentByClass<UWallRunComponent>())
+	{
+		WallRunComp->SetComponentTickInterval(Settings.TickInterval);
+		WallRunComp->WallTraceInterval = Settings.WallTraceInterval;
+		WallRunComp->SetAudioEnabled(Settings.bAudio);
+	}
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Character);
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		Mesh->SetComponentTickInterval(Settings.AnimTickInterval);
+	}
+}
@@ -0,0 +1,171 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunTelemetrySubsystem.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Compression.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunTelemetry, Log, All);
+
+static TAutoConsoleVariable<int32> CVarWallRunTelemetry(
+	TEXT("wallrun.Telemetry"),
+	0,
+	TEXT("Record wallrun events to Saved/Telemetry (applied on next map load)"));
+
+// uncompressed bytes collected before chunk is written
+static constexpr int32 TelemetryChunkSize = 256 * 1024;
+
+// chunk is written at least this often (seconds) so a crash loses little
+static constexpr double TelemetryFlushInterval = 10.0;
+
+
+class FWallRunTelemetryWriter : public FRunnable
+{
+public:
+	FWallRunTelemetryWriter(const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& InQueue, const FString& InFilePrefix)
+		: Queue(InQueue)
+		, FilePrefix(InFilePrefix)
+	{
+		Buffer.Reserve(TelemetryChunkSize + 1024);
+	}
+
+	virtual uint32 Run() override
+	{
+		double LastFlushTime = FPlatformTime::Seconds();
+		while (!bStopping)
+		{
+			Drain();
+			if (Buffer.Num() >= TelemetryChunkSize || (Buffer.Num() > 0 && FPlatformTime::Seconds() - LastFlushTime > TelemetryFlushInterval))
+			{
+				WriteChunk();
+				LastFlushTime = FPlatformTime::Seconds();
+			}
+			FPlatformProcess::Sleep(0.05f);
+		}
+		Drain();
+		WriteChunk();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+	}
+
+private:
+	void Drain()
+	{
+		FMemoryWriter Writer(Buffer, false, true);
+		Writer.Seek(Buffer.Num());
+		FWallRunEvent Event;
+		while (Queue->Dequeue(Event))
+		{
+			FWallRunTelemetryRecord Record;
+			Record.Type = (uint8)Event.Type;
+			Record.Reason = (uint8)Event.Reason;
+			Record.CharacterId = Event.CharacterId;
+			Record.Time = Event.Time;
+			Record.Location = Event.Location;
+			Writer << Record;
+		}
+	}
+
+	void WriteChunk()
+	{
+		if (Buffer.Num() == 0)
+		{
+			return;
+		}
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Buffer.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Buffer.GetData(), Buffer.Num()))
+		{
+			UE_LOG(LogWallRunTelemetry, Warning, TEXT("Failed to compress telemetry chunk"));
+			Buffer.Reset();
+			return;
+		}
+
+		const FString Filename = FString::Printf(TEXT("%s_%04d%s"), *FilePrefix, ChunkIndex++, FWallRunTelemetryRecord::GetFileExtension());
+		TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*Filename));
+		if (File)
+		{
+			uint32 Magic = FWallRunTelemetryRecord::ChunkMagic;
+			int32 UncompressedSize = Buffer.Num();
+			*File << Magic << UncompressedSize << CompressedSize;
+			File->Serialize(Compressed.GetData(), CompressedSize);
+			File->Close();
+		}
+		Buffer.Reset();
+	}
+
+	TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe> Queue;
+	FString FilePrefix;
+	TArray<uint8> Buffer;
+	int32 ChunkIndex = 0;
+	FThreadSafeBool bStopping;
+};
+
+
+bool UWallRunTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	if (!World || !World->IsGameWorld())
+	{
+		return false;
+	}
+	return CVarWallRunTelemetry.GetValueOnGameThread() != 0 || FParse::Param(FCommandLine::Get(), TEXT("WallRunTelemetry"));
+}
+
+void UWallRunTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EventBus = Collection.InitializeDependency<UWallRunEventBus>();
+	if (!EventBus)
+	{
+		return;
+	}
+
+	const FString FilePrefix = FPaths::ProjectSavedDir() / TEXT("Telemetry") /
+		FString::Printf(TEXT("%s_%s"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString());
+	TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe> NewQueue = EventBus->AddThreadConsumer();
+	Queue = NewQueue;
+	Writer = MakeUnique<FWallRunTelemetryWriter>(NewQueue, FilePrefix);
+	WriterThread = FRunnableThread::Create(Writer.Get(), TEXT("WallRunTelemetryWriter"), 0, TPri_BelowNormal);
+	UE_LOG(LogWallRunTelemetry, Log, TEXT("Recording wallrun telemetry to %s_*%s"), *FilePrefix, FWallRunTelemetryRecord::GetFileExtension());
+}
+
+void UWallRunTelemetrySubsystem::Deinitialize()
+{
+	if (EventBus)
+	{
+		// events still queued on the bus go to the file, other subscribers are not broadcast to while the world tears down
+		if (Queue.IsValid())
+		{
+			EventBus->FlushToThreadConsumer(Queue.ToSharedRef());
+			EventBus->RemoveThreadConsumer(Queue.ToSharedRef());
+		}
+	}
+	if (WriterThread)
+	{
+		// Kill calls Stop and waits, writer flushes what's left
+		WriterThread->Kill(true);
+		delete WriterThread;
+		WriterThread = nullptr;
+	}
+	Writer.Reset();
+	Queue.Reset();
+	EventBus = nullptr;
+	Super::Deinitialize();
+}
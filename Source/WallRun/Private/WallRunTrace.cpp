@@ -0,0 +1,67 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunTrace.h"
+
+#if WALLRUN_TRACE_ENABLED
+
+#include "WallRunEventBus.h"
+#include "GameFramework/Actor.h"
+
+UE_TRACE_CHANNEL_DEFINE(WallRunChannel)
+
+// names are sent once per character, state changes only carry the id. important events are cached by trace
+// and sent again to every later session (Trace.Start / new trace file), so those still get the names
+UE_TRACE_EVENT_BEGIN(WallRun, CharacterName, Important)
+	UE_TRACE_EVENT_FIELD(uint32, CharacterId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(WallRun, StateChange)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CharacterId)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+	UE_TRACE_EVENT_FIELD(uint8, Reason)
+	UE_TRACE_EVENT_FIELD(float, NormalX)
+	UE_TRACE_EVENT_FIELD(float, NormalY)
+	UE_TRACE_EVENT_FIELD(float, NormalZ)
+	UE_TRACE_EVENT_FIELD(float, VelocityX)
+	UE_TRACE_EVENT_FIELD(float, VelocityY)
+	UE_TRACE_EVENT_FIELD(float, VelocityZ)
+	UE_TRACE_EVENT_FIELD(float, LocationX)
+	UE_TRACE_EVENT_FIELD(float, LocationY)
+	UE_TRACE_EVENT_FIELD(float, LocationZ)
+UE_TRACE_EVENT_END()
+
+
+void FWallRunTrace::OutputStateChange(const FWallRunEvent& Event, const AActor* Character)
+{
+	// game thread only (events are pushed from tick and collision callbacks), ids are never reused
+	static TSet<uint32> NamedCharacters;
+	if (Character && !NamedCharacters.Contains(Event.CharacterId))
+	{
+		NamedCharacters.Add(Event.CharacterId);
+		const FString Name = Character->GetName();
+		const uint32 NameSize = (Name.Len() + 1) * sizeof(TCHAR);
+		UE_TRACE_LOG(WallRun, CharacterName, WallRunChannel, NameSize)
+			<< CharacterName.CharacterId(Event.CharacterId)
+			<< CharacterName.Attachment(*Name, NameSize);
+	}
+
+	UE_TRACE_LOG(WallRun, StateChange, WallRunChannel)
+		<< StateChange.Cycle(FPlatformTime::Cycles64())
+		<< StateChange.CharacterId(Event.CharacterId)
+		<< StateChange.Type((uint8)Event.Type)
+		<< StateChange.Reason((uint8)Event.Reason)
+		<< StateChange.NormalX(Event.Vector.X)
+		<< StateChange.NormalY(Event.Vector.Y)
+		<< StateChange.NormalZ(Event.Vector.Z)
+		<< StateChange.VelocityX(Event.Velocity.X)
+		<< StateChange.VelocityY(Event.Velocity.Y)
+		<< StateChange.VelocityZ(Event.Velocity.Z)
+		<< StateChange.LocationX(Event.Location.X)
+		<< StateChange.LocationY(Event.Location.Y)
+		<< StateChange.LocationZ(Event.Location.Z);
+}
+
+#endif
@@ -6,6 +6,20 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "WallCharacterMovementComponent.generated.h"
 
+/** Server side prediction quality of one autonomous proxy, see WallRun.BenchmarkNetConditions */
+struct FWallRunNetMoveStats
+{
+	/** client moves checked against server position */
+	int32 NumMoves = 0;
+
+	/** moves answered with a position correction */
+	int32 NumCorrections = 0;
+
+	/** distance between client and server position after the move (cm) */
+	double ErrorSum = 0.0;
+	float MaxError = 0.f;
+};
+
 /**
  * 
  */
@@ -14,6 +28,17 @@ class WALLRUN_API UWallCharacterMovementComponent : public UCharacterMovementCom
 {
 	GENERATED_BODY()
 
+public:
+	/** Collected on server only */
+	FWallRunNetMoveStats NetStats;
+
+	void ResetNetStats() { NetStats = FWallRunNetMoveStats(); }
+
+protected:
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	virtual void SendClientAdjustment() override;
+
 	virtual void Crouch(bool bClientSimulation = false) override;
 	
 	/**
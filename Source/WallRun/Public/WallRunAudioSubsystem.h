@@ -0,0 +1,91 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+class USoundConcurrency;
+class USceneComponent;
+
+// looping sound some owner wants to play, it holds a voice only while audible
+struct FWallRunLoopRequest
+{
+	TWeakObjectPtr<USoundBase> Sound;
+	TWeakObjectPtr<USceneComponent> AttachTo;
+	// null while culled or all voices are taken by closer loops
+	UAudioComponent* Voice = nullptr;
+};
+
+// shared pool of audio components for wallrun loops and concurrency limited one-shot sounds,
+// so characters don't need own audio component and far away characters don't take voices
+UCLASS(config=Game)
+class WALLRUN_API UWallRunAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// how many looping sounds (wallrun) can play at the same time
+	UPROPERTY(config)
+	int32 MaxLoopVoices = 8;
+
+	// how many instances of the same one-shot sound (jump, fire) can play at the same time
+	UPROPERTY(config)
+	int32 MaxOneShotVoices = 4;
+
+	// sounds further from every local listener are not played
+	UPROPERTY(config)
+	float MaxAudibleDistance = 5000.f;
+
+	// start looping sound for Owner attached to AttachTo, returns false if culled for now.
+	// when all voices are busy the furthest one is taken if AttachTo is closer to listener.
+	// culled loops stay requested and get a voice in UpdateLoops once audible
+	bool PlayLoop(const UObject* Owner, USoundBase* Sound, USceneComponent* AttachTo);
+
+	// stop looping sound started by Owner and return its voice to the pool
+	void StopLoop(const UObject* Owner);
+
+	// re-evaluates audibility of every requested loop: voices of loops moved out of range are freed,
+	// the closest audible loops get voices. called on significance update
+	void UpdateLoops();
+
+	// same as UGameplayStatics ones but with concurrency limit and distance culling
+	static void PlaySound2D(const UObject* WorldContextObject, USoundBase* Sound);
+	static void PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, FVector Location);
+
+protected:
+	// whether Location is close enough to any local listener, OutDistSquared - to the closest one
+	bool IsAudible(const FVector& Location, float& OutDistSquared) const;
+
+	UAudioComponent* CreateVoice();
+
+	void ReleaseVoice(UAudioComponent* Voice);
+
+	// free voice, new one, or the one of the furthest loop if it is further than DistSquared
+	UAudioComponent* AcquireVoice(float DistSquared);
+
+	void StartVoice(FWallRunLoopRequest& Request, UAudioComponent* Voice);
+
+	// every voice created by the pool
+	UPROPERTY()
+	TArray<UAudioComponent*> Voices;
+
+	UPROPERTY()
+	TArray<UAudioComponent*> FreeVoices;
+
+	// requested loop of each owner, voices are referenced by Voices
+	TMap<const UObject*, FWallRunLoopRequest> Loops;
+
+	// concurrency group of every one-shot sound played through the pool, so each sound has its own limit
+	UPROPERTY()
+	TMap<USoundBase*, USoundConcurrency*> OneShotConcurrency;
+
+	USoundConcurrency* GetOneShotConcurrency(USoundBase* Sound);
+};
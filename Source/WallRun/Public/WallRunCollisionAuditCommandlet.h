@@ -0,0 +1,46 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WallRunCollisionAuditCommandlet.generated.h"
+
+class UStaticMesh;
+
+/**
+ * Reports collision complexity of static meshes that can be wallrun on (object type in ObjectTypesForWallRun)
+ * and optionally replaces their collision with simple box or convex.
+ * -Fix replaces only complex collision used for queries; meshes with more than 4 simple primitives are reported,
+ * and replaced too only with -SimplifyAuthored (their hand-made collision is lost).
+ *
+ * UE4Editor-Cmd WallRun.uproject -run=WallRunCollisionAudit [-Maps=/Game/Map1+/Game/Map2] [-Pawn=/Game/Path/PawnBlueprint]
+ *		[-ObjectTypes=WorldStatic+WorldDynamic] [-Fix=Box|Convex] [-SimplifyAuthored] [-Report=Path.csv]
+ */
+UCLASS()
+class WALLRUN_API UWallRunCollisionAuditCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunCollisionAuditCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	// collision stats of one mesh over all scanned maps
+	struct FMeshAudit
+	{
+		int32 NumComponents = 0;
+		int32 NumTriangles = 0;
+		int32 NumSimplePrimitives = 0;
+		bool bComplexAsSimple = false;
+	};
+
+	// relative cost of one query against the mesh, complex collision cost grows with triangles (BVH depth and leaf tests)
+	static float EstimateQueryCost(const FMeshAudit& Audit);
+
+	// replace mesh collision with one box (bConvex = false) or 26-DOP convex around render vertices
+	static bool SimplifyCollision(UStaticMesh* Mesh, bool bConvex);
+};
@@ -5,10 +5,12 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WallRunEventBus.h"
+#include "WallRunFeatures.h"
+#include "WallRunJumpPrediction.h"
 #include "WallRunComponent.generated.h"
 
 class UCharacterMovementComponent;
-class UAudioComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWallEventDelegate, FVector, WallNormal);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOffWallEventDelegate);
@@ -18,6 +20,53 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FClimbEventDelegate, FVector, Impact
 // e.g. Message = FString::Printf(TEXT("x: %f"), f)
 #define PrintToScreen(Duration, Message) GEngine->AddOnScreenDebugMessage(-1, Duration, FColor::White, Message) 
 
+// character movement relative to its look direction and the wall, recalculated only when they change
+USTRUCT(BlueprintType)
+struct FWallRunKinematics
+{
+	GENERATED_BODY()
+
+	// normalized velocity (zero if not moving)
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	FVector VelocityDir = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	float Speed = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	FVector Forward = FVector::ForwardVector;
+
+	// < 0 - moving backwards
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	float ForwardDotVelocity = 0.f;
+
+	// > 0 - moving away from wall
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	float VelocityDotWallNormal = 0.f;
+
+	// sign is the wall side
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	float VelocityDotWallDirection = 0.f;
+
+	// < 0 - looking at wall
+	UPROPERTY(BlueprintReadOnly, Category = "WallRun")
+	float ForwardDotWallNormal = 0.f;
+
+	// what snapshot was built from, to know when it's outdated. several moves run in one frame
+	// (server processing client moves, client replaying saved moves) with different rotations and velocities
+	FQuat SourceRotation = FQuat(0.f, 0.f, 0.f, 0.f);
+	FVector SourceVelocity = FVector::ZeroVector;
+	FVector SourceWallNormal = FVector::ZeroVector;
+	FVector SourceWallDirection = FVector::ZeroVector;
+
+	// rebuilds what changed since last update. also used for simulated movement (nav links, prediction),
+	// so launch velocities everywhere come from the same numbers
+	void Update(const FQuat& Rotation, const FVector& Velocity, const FVector& WallNormal, const FVector& WallDirection);
+
+	// wall on the right side (1) or on the left side (-1) of movement
+	float GetWallSide() const { return VelocityDotWallDirection < 0.f ? -1.f : 1.f; }
+};
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class WALLRUN_API UWallRunComponent : public UActorComponent
@@ -76,24 +125,115 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallJump")
 	float MaxWallJumpVelocity;
 
+	// velocity character is launched with when it sticks to wall with given normal, InKinematics must be built against that wall
+	// same formula is used by AI navigation and prediction, so keep them in sync through this function
+	FVector CalculateStickLaunchVelocity(const FVector& InWallNormal, const FWallRunKinematics& InKinematics, const FVector& InputVector) const;
+
+	// velocity character is launched with when it jumps off wall with given normal, clamped by MaxWallJumpVelocity
+	FVector CalculateWallJumpVelocity(const FVector& InWallNormal, const FWallRunKinematics& InKinematics, const FVector& InputVector) const;
+
+	// where wall jump from current wall with given movement input would land (owner's capsule swept along the arc)
+	UFUNCTION(BlueprintCallable, Category = "WallJump")
+	bool PredictWallJump(FVector InputVector, FWallRunJumpPrediction& OutPrediction, float MaxTime = 2.f) const;
+
+	// prediction for many inputs at once, e.g. AI choosing a jump; collision setup is shared between candidates
+	void PredictWallJumps(TArrayView<const FVector> InputVectors, TArray<FWallRunJumpPrediction>& OutPredictions, float MaxTime = 2.f) const;
+
+	// gravity of the wall jump arc: jumping calls OffWall first, so it's default gravity scale, not the wallrun one
+	float GetWallJumpGravityZ() const;
+
+	// max distance (cm) between predicted arc and chords swept along it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallJump")
+	float PredictionTolerance;
+
+	// how long (seconds) jump or crouch pressed in the air is remembered and applied once the wall allows it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallJump")
+	float InputBufferTime;
+
+	// remember jump press so it turns into wall jump if wall is reached within InputBufferTime
+	void BufferJump();
+
+	// remember crouch press so wall reached within InputBufferTime is not sticked to
+	void BufferDetach();
+
+	// true (and clears buffer) if jump was buffered and wall jump is possible now
+	bool ConsumeBufferedJump();
+
+	// share of buffered jump/crouch presses which were applied (0-1)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "WallJump")
+	float GetBufferedInputHitRate() const;
+
 	// how much velocity added to climb ledge
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
 	float ClimbStrength;
 
+	// climb ledge with predicted root motion (FRootMotionSource_WallRunLedgeClimb)
+	// off - ClimbEvent is expected to move character in blueprint, as before
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LedgeClimb")
+	bool bNativeLedgeClimb;
+
+	// how long climb takes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LedgeClimb", meta = (ClampMin = "0.05", EditCondition = "bNativeLedgeClimb"))
+	float ClimbDuration;
+
+	// part of ClimbDuration spent rising along the wall, rest is moving onto the ledge (0-1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LedgeClimb", meta = (ClampMin = "0.05", ClampMax = "0.95", EditCondition = "bNativeLedgeClimb"))
+	float ClimbRiseFraction;
+
+	// how far behind the wall face character ends up (capsule radius is added)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LedgeClimb", meta = (EditCondition = "bNativeLedgeClimb"))
+	float LedgeForwardDistance;
+
+	// highest ledge top above character's center that can be climbed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LedgeClimb", meta = (EditCondition = "bNativeLedgeClimb"))
+	float MaxLedgeHeight;
+
 	// least allowed deviation of movement from wall 0-1;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
 	float AllowedDeviationFromWall;
 
+	// how far from character the wall is traced every tick while wallrunning
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	float WallTraceLength;
+
+	// max angle (degrees) between wall normals to treat them as the same wall (curved or segmented walls)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	float SameWallAngle;
+
+	// how fast WallNormal follows the traced wall, 0 - snap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	float WallNormalInterpSpeed;
+
+	// how long (seconds) wall trace may miss before wallrun stops, to pass over gaps between wall segments
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	float WallLostGraceTime;
+
+	// how often (seconds) wall is traced while wallrunning, 0 - every tick (raised for far away characters)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	float WallTraceInterval;
+
+	// while falling, sweep capsule along this frame's move and if it reaches a wall, move to the contact and stick
+	// with full momentum and without the impact (instead of waiting for OnHit).
+	// standalone only: it moves the character outside of CharacterMovement saved moves, which server would correct
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
+	bool bPredictiveWallAcquisition;
+
+	// how often (seconds) the sweep runs while falling, 0 - every tick (at least WallTraceInterval)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun", meta = (EditCondition = "bPredictiveWallAcquisition"))
+	float AcquisitionInterval;
+
+	// whether wallrun sound can be played (off for far away characters)
+	void SetAudioEnabled(bool bEnabled);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
-	USoundBase* WallRunSound;
+	TSoftObjectPtr<USoundBase> WallRunSound;
 
 
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-	UPROPERTY()
-	UAudioComponent* AudioRunComp;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// reference to player's character
 	UPROPERTY()
@@ -134,10 +274,29 @@ protected:
 	UPROPERTY()
 	float LastWallSide = 0.f;
 
+	// how long wall trace is missing in current wallrun
+	float WallLostTime;
+
+	float TimeSinceWallTrace;
+
+	float TimeSinceAcquisition;
+
+	bool bAudioEnabled;
+
+	// whether wall with this normal is the one player runs on (within SameWallAngle)
+	bool IsSameWall(const FVector& Normal) const;
+
+	// smoothly turn WallNormal and WallDirection to the traced wall
+	void FollowWall(const FVector& Normal, float DeltaTime);
+
 	// implement wallrunning state
 	UFUNCTION()
 	void StickToWall();
 
+	// WallRunDuration elapsed
+	UFUNCTION()
+	void WallRunTimeout();
+
 
 
 	UPROPERTY()
@@ -146,18 +305,77 @@ protected:
 	UPROPERTY()
 	bool bClimbingLedge;
 
+	// failed ledge climb was already recorded during this wallrun
+	bool bClimbFailRecorded;
+
+	uint32 CharacterId;
+
+	// world time of buffered presses, negative if nothing buffered
+	float BufferedJumpTime;
+	float BufferedDetachTime;
+
+	uint32 NumBufferedInputs;
+	uint32 NumBufferedInputHits;
+
+	// true (and clears buffer) if press at BufferedTime is still within InputBufferTime
+	bool ConsumeBufferedInput(float& BufferedTime);
+
+	FWallRunKinematics Kinematics;
+
+	// standable top of the ledge in front (walkable floor, capsule fits), as capsule center location
+	bool FindLedgeTop(FVector& OutClimbTarget) const;
+
+	// apply ledge climb root motion towards ClimbTarget
+	void StartLedgeClimb(const FVector& ClimbTarget);
+
+	// queue event to UWallRunEventBus, subscribers get it later this frame
+	void PushEvent(EWallRunEventType Type, const FVector& Vector = FVector::ZeroVector, EWallRunOffWallReason Reason = EWallRunOffWallReason::Other);
+
+	// StickToWall, OffWall, WallJump, OnHit, TickComponent and PushEvent for one compile-time feature set (WallRunFeatures.h)
+	// public functions pick FWallRunLeanPolicy or FWallRunDefaultPolicy by bLeanFeatures
+	template <typename TPolicy> void StickToWallImpl();
+	template <typename TPolicy> void OffWallImpl(EWallRunOffWallReason Reason);
+	template <typename TPolicy> void WallJumpImpl();
+	template <typename TPolicy> void HandleHit(const FHitResult& Hit);
+	template <typename TPolicy> void TickWallRun(float DeltaTime);
+	template <typename TPolicy> void TryAcquireWall(float DeltaTime);
+	template <typename TPolicy> void PushEventImpl(EWallRunEventType Type, const FVector& Vector, EWallRunOffWallReason Reason);
+
+	friend struct FWallRunPolicyBenchmark;
+
 public:	
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WallRun")
 	bool DebugLog;
 
+	// wallrun without ledge climb, coyote time, audio, debug log and telemetry (compiled out, not skipped at runtime)
+	// for pawns that never use them, e.g. AI. blueprint events still fire, but the event bus and trace are skipped:
+	// bus subscribers (stats, net benchmark event counts) never see lean pawns
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "WallRun")
+	bool bLeanFeatures;
+
 	// stop wallrunning state
 	UFUNCTION(BlueprintCallable, Category = "WallRun")
-	void OffWall();
+	void OffWall(EWallRunOffWallReason Reason = EWallRunOffWallReason::Other);
+
+	// back to state of freshly spawned character (no wall, no buffered input, no timers, default gravity), without events
+	// used when character is returned to pawn pool
+	void ResetWallRunState();
+
+	// id of the character in events, telemetry and trace; assigned at BeginPlay from a process-wide counter,
+	// never reused unlike UObject unique ids. 0 before BeginPlay
+	uint32 GetCharacterId() const { return CharacterId; }
 
 	UFUNCTION(BlueprintNativeEvent, Category = "WallRun")
 	void OnHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit);
 
+	// velocity, look direction and their relation to the wall for this frame
+	// rebuilt only when rotation, velocity or wall changes, so it's cheap to call from input, animation or AI
+	const FWallRunKinematics& GetKinematics();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "WallRun", meta = (DisplayName = "Get Kinematics"))
+	FWallRunKinematics K2_GetKinematics() { return GetKinematics(); }
+
 	// calculate whether player moves backwards, based on his look direction and velocity
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "WallRun")
 	bool IsCharacterMovingBackwards();
@@ -186,6 +404,9 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "WallRun")
 	FClimbEventDelegate ClimbEvent;
 
+	// called by UWallRunEventBus when event pushed by this component is dispatched, broadcasts blueprint events
+	void BroadcastEvent(const FWallRunEvent& Event);
+
 
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
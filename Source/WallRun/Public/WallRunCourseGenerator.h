@@ -0,0 +1,107 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WallRunCourseGenerator.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+// generates large repeatable wallrun courses (walls, pillars, ledges) from a seed for stress testing
+// every piece is an instance, so draw calls and collision setup don't grow with course size.
+// replicated: a course spawned on server is generated on every client from the same seed
+UCLASS()
+class WALLRUN_API AWallRunCourseGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AWallRunCourseGenerator();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Course")
+	int32 Seed;
+
+	// how many wall segments along the course
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Course", meta = (ClampMin = "1"))
+	int32 NumSegments;
+
+	// how many parallel lanes of segments
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Course", meta = (ClampMin = "1"))
+	int32 NumLanes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	float LaneWidth;
+
+	// random wall length range
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	FVector2D WallLength;
+
+	// random wall height range
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	FVector2D WallHeight;
+
+	// random gap between walls along the course
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	FVector2D WallGap;
+
+	// distance between walls on both sides of lane (for wall jumps)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	float WallSpacing;
+
+	// chance (0-1) of a pillar in a gap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	float PillarChance;
+
+	// chance (0-1) of a climbable ledge at the end of a wall
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	float LedgeChance;
+
+	// how many bot spawn points at the start of every lane
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	int32 SpawnPointsPerLane;
+
+	// generate in construction script (every time actor is moved or edited)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	bool bGenerateOnConstruction;
+
+	// generate when play begins, on server and on clients once replicated settings arrived
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Course")
+	bool bGenerateOnBeginPlay;
+
+	// where bots should be spawned, relative to this actor
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Course")
+	TArray<FTransform> SpawnPoints;
+
+	// remove old course and build a new one from current settings
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Course")
+	void Generate();
+
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Course")
+	void Clear();
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// mesh is scaled as 1m cube (like engine's basic cube), it should have simple collision
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Course")
+	UStaticMesh* BlockMesh;
+
+protected:
+	virtual void BeginPlay() override;
+
+	UPROPERTY(VisibleAnywhere, Category = "Course")
+	UHierarchicalInstancedStaticMeshComponent* Walls;
+
+	UPROPERTY(VisibleAnywhere, Category = "Course")
+	UHierarchicalInstancedStaticMeshComponent* Pillars;
+
+	UPROPERTY(VisibleAnywhere, Category = "Course")
+	UHierarchicalInstancedStaticMeshComponent* Ledges;
+
+	// instance of BlockMesh with given center and size (cm)
+	static FTransform MakeBlock(const FVector& Center, const FVector& Size, float Yaw = 0.f);
+};
@@ -0,0 +1,184 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WallRunCourseStreamer.generated.h"
+
+class ULevelStreaming;
+
+// one streamed piece of a course. precomputed wall data (nav link generator with its cells, ...) is placed
+// in the chunk level itself, so it is loaded and registered together with the geometry it was built from
+USTRUCT(BlueprintType)
+struct FWallRunCourseChunk
+{
+	GENERATED_BODY()
+
+	// sublevel, authored in world space. networked games stream only sublevels listed in the persistent level
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	TSoftObjectPtr<UWorld> Level;
+
+	// world bounds of the chunk, filled by CollectChunks
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	FBox Bounds = FBox(ForceInit);
+};
+
+// reported by WallRun.StreamingReport and at the end of WallRun.StreamingFlythrough
+USTRUCT(BlueprintType)
+struct FWallRunStreamingStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 NumLoads = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 NumUnloads = 0;
+
+	// times a player got inside a chunk that wasn't visible yet
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 NumStalls = 0;
+
+	// seconds spent inside chunks that weren't visible
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float StallTime = 0.f;
+
+	// from request to visible
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float MaxLoadLatency = 0.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float TotalLoadLatency = 0.f;
+
+	// package file sizes of loaded chunks
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int64 BytesLoaded = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 PeakResidentChunks = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int64 PeakUsedPhysical = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float Time = 0.f;
+};
+
+// streams course chunks around players: chunks along the predicted path (velocity, or wall direction while wallrunning)
+// are loaded asynchronously before player reaches them, chunks left behind are unloaded.
+// runs on server for every player and on clients for the local one, clients report visibility to server as usual
+UCLASS()
+class WALLRUN_API AWallRunCourseStreamer : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AWallRunCourseStreamer();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	TArray<FWallRunCourseChunk> Chunks;
+
+	// chunks this close to a player are always loaded
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming")
+	float LoadRadius;
+
+	// loaded chunks are kept until player is this far (> LoadRadius, so chunks on the border don't flicker)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming")
+	float UnloadRadius;
+
+	// how far ahead (seconds) the path is predicted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming")
+	float LookAheadTime;
+
+	// chunks this close to predicted path are loaded
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming")
+	float PathRadius;
+
+	// points checked along predicted path
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming", meta = (ClampMin = "1"))
+	int32 PathSamples;
+
+	// loads in flight, soonest reached chunks go first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming", meta = (ClampMin = "1"))
+	int32 MaxConcurrentLoads;
+
+	// seconds between load/unload decisions
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Streaming")
+	float UpdateInterval;
+
+	// fills Chunks from sublevels of this world loaded in editor
+	UFUNCTION(CallInEditor, Category = "Streaming")
+	void CollectChunks();
+
+	UFUNCTION(BlueprintCallable, Category = "Streaming")
+	const FWallRunStreamingStats& GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "Streaming")
+	void ResetStats();
+
+	void LogStats() const;
+
+	int32 GetNumResidentChunks() const;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	struct FViewer
+	{
+		FVector Location;
+		// velocity, or along the wall while wallrunning
+		FVector PredictedVelocity;
+	};
+
+	struct FChunkState
+	{
+		TWeakObjectPtr<ULevelStreaming> Streaming;
+		bool bRequested = false;
+		bool bVisible = false;
+		// player is inside while it isn't visible
+		bool bStalled = false;
+		// can't be streamed in this world, not requested again
+		bool bUnavailable = false;
+		float RequestTime = 0.f;
+		int64 PackageBytes = -1;
+	};
+
+	TArray<FChunkState> States;
+
+	TArray<FViewer> Viewers;
+
+	// last location of viewer pawns, for velocity of teleported (flythrough) pawns
+	TMap<TWeakObjectPtr<APawn>, FVector> LastLocations;
+
+	float UpdateTimer;
+
+	FWallRunStreamingStats Stats;
+
+	void GatherViewers(float DeltaSeconds);
+
+	void PollChunks(float DeltaSeconds);
+
+	void UpdateChunks();
+
+	// seconds until a viewer reaches the chunk along predicted path, < 0 if it doesn't
+	float GetTimeToReach(const FBox& Bounds) const;
+
+	bool IsNearViewer(const FBox& Bounds, float Radius) const;
+
+	// squared distance from the closest viewer, 0 if a viewer is inside
+	float GetDistSquaredToViewer(const FBox& Bounds) const;
+
+	ULevelStreaming* FindOrCreateStreamingLevel(int32 ChunkIndex);
+
+	void RequestLoad(int32 ChunkIndex);
+
+	void RequestUnload(int32 ChunkIndex);
+
+	static int64 GetPackageBytes(const FString& PackageName);
+};
@@ -0,0 +1,123 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h"
+#include "WallRunEventBus.generated.h"
+
+class UWallRunComponent;
+
+// why wallrun stopped
+UENUM(BlueprintType)
+enum class EWallRunOffWallReason : uint8
+{
+	Other,
+	// WallRunDuration elapsed
+	Timeout,
+	// moved away from wall
+	Deviation,
+	// wall ended
+	WallEnd,
+	Crouch,
+	Jump,
+	Climb,
+	Land,
+};
+
+enum class EWallRunEventType : uint8
+{
+	Stick,
+	Unstick,
+	Jump,
+	Climb,
+	Land,
+	// faced the ledge while wallrunning but no room on top, once per wallrun
+	ClimbFail,
+};
+
+// one wallrun event, plain data so it can be copied to other threads
+struct FWallRunEvent
+{
+	EWallRunEventType Type = EWallRunEventType::Stick;
+
+	// only for unstick
+	EWallRunOffWallReason Reason = EWallRunOffWallReason::Other;
+
+	// UWallRunComponent::GetCharacterId, unique per character for the whole process, safe to use off game thread
+	uint32 CharacterId = 0;
+
+	float Time = 0.f;
+
+	FVector Location = FVector::ZeroVector;
+
+	// wall normal for stick/unstick/jump, impact point for climb and failed climb
+	FVector Vector = FVector::ZeroVector;
+
+	FVector Velocity = FVector::ZeroVector;
+
+	// component that pushed the event, only for game thread subscribers
+	TWeakObjectPtr<UWallRunComponent> Source;
+};
+
+// queue a worker thread consumer drains on its own (single producer - dispatch on game thread, single consumer)
+typedef TQueue<FWallRunEvent, EQueueMode::Spsc> FWallRunEventQueue;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FWallRunEventBatchDelegate, TArrayView<const FWallRunEvent> /* Events */);
+
+struct FWallRunEventBusTickFunction : public FTickFunction
+{
+	class UWallRunEventBus* Bus = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return TEXT("WallRunEventBus"); }
+};
+
+// wallrun events are pushed into a lock-free queue from anywhere (collision callbacks)
+// and dispatched in one batch per frame at DispatchTickGroup instead of running subscribers inline
+UCLASS()
+class WALLRUN_API UWallRunEventBus : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// thread safe
+	void Push(const FWallRunEvent& Event);
+
+	// called on game thread with every event of the frame
+	FWallRunEventBatchDelegate OnEvents;
+
+	// new queue that receives a copy of every event, drain it from any (one) thread
+	TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe> AddThreadConsumer();
+
+	void RemoveThreadConsumer(const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& Queue);
+
+	// send queued events to subscribers
+	void Dispatch();
+
+	// copy queued events to one thread consumer only, they stay queued for everyone else
+	void FlushToThreadConsumer(const TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>& Queue);
+
+	// tick group events are dispatched in, after movement and collision by default
+	ETickingGroup DispatchTickGroup = TG_PostPhysics;
+
+protected:
+	TQueue<FWallRunEvent, EQueueMode::Mpsc> PendingEvents;
+
+	// reused every dispatch to avoid allocations
+	TArray<FWallRunEvent> Batch;
+
+	TArray<TSharedRef<FWallRunEventQueue, ESPMode::ThreadSafe>> ThreadConsumers;
+
+	FCriticalSection ThreadConsumersLock;
+
+	FWallRunEventBusTickFunction TickFunction;
+
+	// tick function is registered on first push from game thread, when level exists
+	void RegisterTickFunction();
+};
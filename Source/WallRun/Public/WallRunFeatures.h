@@ -0,0 +1,49 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// compile-time feature set of UWallRunComponent logic. a target can force a feature off in its Build.cs
+// (e.g. PublicDefinitions.Add("WALLRUN_WITH_LEDGE_CLIMB=0")), code of disabled features is not compiled into the logic
+
+#ifndef WALLRUN_WITH_LEDGE_CLIMB
+#define WALLRUN_WITH_LEDGE_CLIMB 1
+#endif
+
+// jump from wall allowed for CoyoteTime after leaving it
+#ifndef WALLRUN_WITH_COYOTE_TIME
+#define WALLRUN_WITH_COYOTE_TIME 1
+#endif
+
+// wallrun loop sound, nobody listens on dedicated server
+#ifndef WALLRUN_WITH_AUDIO
+#define WALLRUN_WITH_AUDIO !UE_SERVER
+#endif
+
+// DebugLog property, log calls and their formatting are not compiled in shipping and test
+#ifndef WALLRUN_WITH_DEBUG_LOG
+#define WALLRUN_WITH_DEBUG_LOG !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+// events go through UWallRunEventBus (telemetry, audio and other subscribers) and UE Trace
+#ifndef WALLRUN_WITH_TELEMETRY
+#define WALLRUN_WITH_TELEMETRY 1
+#endif
+
+template <bool bInLedgeClimb, bool bInCoyoteTime, bool bInAudio, bool bInDebugLog, bool bInTelemetry>
+struct TWallRunFeaturePolicy
+{
+	static constexpr bool bLedgeClimb = bInLedgeClimb;
+	static constexpr bool bCoyoteTime = bInCoyoteTime;
+	static constexpr bool bAudio = bInAudio;
+	static constexpr bool bDebugLog = bInDebugLog;
+	static constexpr bool bTelemetry = bInTelemetry;
+};
+
+// everything this build has
+using FWallRunDefaultPolicy = TWallRunFeaturePolicy<WALLRUN_WITH_LEDGE_CLIMB != 0, WALLRUN_WITH_COYOTE_TIME != 0, WALLRUN_WITH_AUDIO != 0, WALLRUN_WITH_DEBUG_LOG != 0, WALLRUN_WITH_TELEMETRY != 0>;
+
+// movement only, for pawns that never climb, jump late, play sound or report (AI, background crowds)
+using FWallRunLeanPolicy = TWallRunFeaturePolicy<false, false, false, false, false>;
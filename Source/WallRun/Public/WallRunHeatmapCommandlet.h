@@ -0,0 +1,25 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WallRunHeatmapCommandlet.generated.h"
+
+/**
+ * Aggregates wallrun telemetry files (see UWallRunTelemetrySubsystem) into a 2D heatmap of event counts per cell.
+ *
+ * UE4Editor-Cmd WallRun.uproject -run=WallRunHeatmap [-Input=Dir] [-Map=MapName] [-CellSize=200] [-Output=Path.csv]
+ * Output rows: Event,Reason,CellX,CellY,WorldX,WorldY,Count
+ */
+UCLASS()
+class WALLRUN_API UWallRunHeatmapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunHeatmapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,55 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// character state at some moment in the past
+struct FWallRunHistorySample
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	float CapsuleHalfHeight = 0.f;
+	bool bOnWall = false;
+};
+
+// fixed size ring buffer of character capsule transforms and wallrun state for server side rewind (lag compensation)
+// every field is stored in its own preallocated array, so searching by time only walks Times
+struct WALLRUN_API FWallRunHistory
+{
+	// allocate storage for Capacity samples, the only allocation this history does
+	void Init(int32 Capacity);
+
+	// drop all samples, keep storage
+	void Reset();
+
+	// add newest sample, overwrites oldest when full. Time must not decrease
+	void Record(float Time, const FVector& Location, const FQuat& Rotation, float CapsuleHalfHeight, bool bOnWall);
+
+	// interpolated state at Time (clamped to recorded range), false if nothing recorded
+	bool Sample(float Time, FWallRunHistorySample& OutSample) const;
+
+	int32 Num() const { return Count; }
+
+	float GetOldestTime() const { return Count > 0 ? Times[ToBufferIndex(0)] : 0.f; }
+
+	float GetNewestTime() const { return Count > 0 ? Times[ToBufferIndex(Count - 1)] : 0.f; }
+
+private:
+	// index in arrays of i-th sample counting from the oldest
+	int32 ToBufferIndex(int32 Index) const { return (Head - Count + Index + Capacity) % Capacity; }
+
+	TArray<float> Times;
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+	TArray<float> CapsuleHalfHeights;
+	TArray<bool> OnWall;
+
+	int32 Capacity = 0;
+
+	// where next sample is written
+	int32 Head = 0;
+
+	int32 Count = 0;
+};
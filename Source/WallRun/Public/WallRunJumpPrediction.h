@@ -0,0 +1,63 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "WallRunJumpPrediction.generated.h"
+
+// where a jump lands
+USTRUCT(BlueprintType)
+struct FWallRunJumpPrediction
+{
+	GENERATED_BODY()
+
+	// false if nothing was hit within prediction time
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	bool bLands = false;
+
+	// center of the swept shape when it touches the surface (or at the end of prediction time)
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	FVector ImpactNormal = FVector::ZeroVector;
+
+	// seconds from launch to landing
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	float Time = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	FVector LaunchVelocity = FVector::ZeroVector;
+
+	// highest point of the arc
+	UPROPERTY(BlueprintReadOnly, Category = "WallJump")
+	FVector Apex = FVector::ZeroVector;
+};
+
+// closed-form ballistic arc p(t) = Start + Velocity * t + 0.5 * Gravity * t^2, gravity along Z
+namespace WallRunBallistics
+{
+	FORCEINLINE FVector PositionAt(const FVector& Start, const FVector& Velocity, float GravityZ, float Time)
+	{
+		return Start + Velocity * Time + FVector(0.f, 0.f, 0.5f * GravityZ * Time * Time);
+	}
+
+	// highest point of the arc (start if launched downwards)
+	WALLRUN_API FVector Apex(const FVector& Start, const FVector& Velocity, float GravityZ);
+
+	// earliest time >= MinTime the arc enters plane from its front side, false if it never does
+	WALLRUN_API bool IntersectPlane(const FVector& Start, const FVector& Velocity, float GravityZ, const FPlane& Plane, float MinTime, float& OutTime);
+
+	// sweeps Shape along the arc in chords which deviate from it no more than Tolerance (cm), then solves
+	// the exact contact time against the hit surface, so a 2 s jump costs about 6 sweeps instead of one per sim step.
+	// shapes overlapping at Start (the wall jumped off) are ignored
+	WALLRUN_API bool PredictLanding(const UWorld* World, const FVector& Start, const FVector& Velocity, float GravityZ, const FCollisionShape& Shape,
+		ECollisionChannel Channel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, float MaxTime, float Tolerance,
+		FWallRunJumpPrediction& OutPrediction);
+}
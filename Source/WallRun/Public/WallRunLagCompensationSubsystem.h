@@ -0,0 +1,45 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunLagCompensationSubsystem.generated.h"
+
+class AWallRunCharacter;
+
+// server side hit validation against characters moved back to the time shooter saw them
+UCLASS(config=Game)
+class WALLRUN_API UWallRunLagCompensationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// how far back (seconds) shots are allowed to rewind, older timestamps are clamped
+	UPROPERTY(config)
+	float MaxRewindTime = 1.f;
+
+	void RegisterCharacter(AWallRunCharacter* Character);
+
+	void UnregisterCharacter(AWallRunCharacter* Character);
+
+	/**
+	 * Traces segment against capsules of all registered characters as they were at Time.
+	 * @param	Shooter			character that shot, ignored
+	 * @param	Time			server world time the shooter saw targets at
+	 * @param	OutHitCharacter	closest character along the segment
+	 * @param	OutHitLocation	point on the segment closest to the hit capsule axis
+	 * @return	true if any character was hit
+	 */
+	bool RewindLineTrace(const AActor* Shooter, const FVector& Start, const FVector& End, float Time, AWallRunCharacter*& OutHitCharacter, FVector& OutHitLocation) const;
+
+	// whether Target capsule (as it was at Time) is within Tolerance of HitLocation
+	bool ConfirmHit(const AWallRunCharacter* Target, const FVector& HitLocation, float Time, float Tolerance = 20.f) const;
+
+protected:
+	UPROPERTY()
+	TArray<AWallRunCharacter*> Characters;
+
+	float ClampRewindTime(float Time) const;
+};
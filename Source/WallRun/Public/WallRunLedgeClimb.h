@@ -0,0 +1,48 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/RootMotionSource.h"
+#include "WallRunLedgeClimb.generated.h"
+
+// ledge climb as root motion: rises along the wall to the height of TargetLocation, then moves across onto the ledge.
+// straight move-to would cut through the ledge corner. applied inside movement update on owning client and server,
+// so it is predicted, saved with moves and replicated to simulated proxies like any other root motion source
+USTRUCT()
+struct WALLRUN_API FRootMotionSource_WallRunLedgeClimb : public FRootMotionSource_MoveToForce
+{
+	GENERATED_USTRUCT_BODY()
+
+	// part of Duration spent rising (0-1)
+	UPROPERTY()
+	float RiseFraction = 0.6f;
+
+	static const FName InstanceNameDefault;
+
+	// where the path is at MoveFraction (0-1) of Duration
+	FVector GetLocationAt(float MoveFraction) const;
+
+	virtual FRootMotionSource* Clone() const override;
+
+	virtual bool Matches(const FRootMotionSource* Other) const override;
+
+	virtual void PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character, const UCharacterMovementComponent& MoveComponent) override;
+
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+
+	virtual UScriptStruct* GetScriptStruct() const override;
+
+	virtual FString ToSimpleString() const override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRootMotionSource_WallRunLedgeClimb> : public TStructOpsTypeTraitsBase2<FRootMotionSource_WallRunLedgeClimb>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true,
+	};
+};
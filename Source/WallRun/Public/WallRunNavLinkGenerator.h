@@ -0,0 +1,275 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "AI/Navigation/NavRelevantInterface.h"
+#include "NavLinkHostInterface.h"
+#include "NavAreas/NavArea.h"
+#include "WallRunNavLinkGenerator.generated.h"
+
+class UBoxComponent;
+class UWallRunComponent;
+class AWallRunCharacter;
+
+UENUM(BlueprintType)
+enum class EWallRunTraversal : uint8
+{
+	// run along the wall and drop down at its end
+	WallRun,
+	// stick to the wall and jump off it
+	WallJump
+};
+
+// nav area of wallrun links, AI query filters can exclude or reprice it
+UCLASS()
+class WALLRUN_API UWallRunNavArea_WallRun : public UNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunNavArea_WallRun();
+};
+
+// nav area of wall jump links
+UCLASS()
+class WALLRUN_API UWallRunNavArea_WallJump : public UNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunNavArea_WallJump();
+};
+
+// wallrun links that take much longer than walking their length, recast prices links by length only
+UCLASS()
+class WALLRUN_API UWallRunNavArea_WallRunSlow : public UWallRunNavArea_WallRun
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunNavArea_WallRunSlow();
+};
+
+// wall jump links that take much longer than walking their length
+UCLASS()
+class WALLRUN_API UWallRunNavArea_WallJumpSlow : public UWallRunNavArea_WallJump
+{
+	GENERATED_BODY()
+
+public:
+	UWallRunNavArea_WallJumpSlow();
+};
+
+USTRUCT(BlueprintType)
+struct FWallRunNavLink
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	EWallRunTraversal Type = EWallRunTraversal::WallRun;
+
+	// world space, on the ground in front of the wall
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	FVector Start = FVector::ZeroVector;
+
+	// world space, where character lands
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	FVector End = FVector::ZeroVector;
+
+	// wall character has to stick to
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	FVector WallNormal = FVector::ZeroVector;
+
+	// simulated traversal time (seconds), from touching the wall to landing
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	float Duration = 0.f;
+
+	// distance character would run in Duration, path cost of the link for AI that scores links itself
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	float Cost = 0.f;
+
+	// Cost per unit of straight line length, nav mesh area of the link is picked by it
+	float GetCostRatio() const
+	{
+		const float Length = FVector::Dist(Start, End);
+		return Length > KINDA_SMALL_NUMBER ? Cost / Length : 1.f;
+	}
+};
+
+// links found from wall probes starting in one cell of the generator grid
+USTRUCT()
+struct FWallRunNavCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FIntPoint Coord = FIntPoint::ZeroValue;
+
+	// geometry the links were generated from, cell is regenerated only when it changes
+	UPROPERTY()
+	uint32 GeometryHash = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = "Navigation")
+	TArray<FWallRunNavLink> Links;
+};
+
+// finds wall-run and wall-jump traversals inside its box and exposes them to the nav mesh as one-way links.
+// traversals are simulated with UWallRunComponent launch formulas and settings of CharacterClass.
+// the box is split in cells, rebuild only regenerates cells which geometry changed since the last one.
+UCLASS()
+class WALLRUN_API AWallRunNavLinkGenerator : public AActor, public INavLinkHostInterface, public INavRelevantInterface
+{
+	GENERATED_BODY()
+
+public:
+	AWallRunNavLinkGenerator();
+
+	// character which wallrun settings (launch strengths, gravity, duration) are used for simulation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	TSubclassOf<AWallRunCharacter> CharacterClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "100"))
+	float CellSize;
+
+	// distance between ground samples walls are probed from
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "25"))
+	float SampleSpacing;
+
+	// how far from ground sample walls are searched
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	float ProbeLength;
+
+	// horizontal directions walls are searched in from every ground sample
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "1"))
+	int32 NumProbeDirections;
+
+	// shortest link worth adding, shorter traversals are walkable anyway
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	float MinLinkLength;
+
+	// simulation time step (seconds)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "0.01"))
+	float SimulationStep;
+
+	// how many moments along a wallrun a wall jump is tried from
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "1"))
+	int32 WallJumpSamples;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	TSubclassOf<UNavArea> WallRunArea;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	TSubclassOf<UNavArea> WallJumpArea;
+
+	// links which Cost per length is above SlowLinkRatio use slow areas
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation", meta = (ClampMin = "1"))
+	float SlowLinkRatio;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	TSubclassOf<UNavArea> WallRunSlowArea;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	TSubclassOf<UNavArea> WallJumpSlowArea;
+
+	// rebuild when an actor inside the box is moved in editor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Navigation")
+	bool bRebuildOnGeometryChange;
+
+	// regenerate cells which geometry changed, returns how many were regenerated
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Navigation")
+	int32 Rebuild();
+
+	// regenerate every cell
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Navigation")
+	void RebuildAll();
+
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+	void GetLinks(TArray<FWallRunNavLink>& OutLinks) const;
+
+	// time (ms) and cell count of the last rebuild
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	float LastRebuildTimeMs;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Navigation")
+	int32 LastRebuildCells;
+
+	// INavLinkHostInterface
+	virtual bool GetNavigationLinksClasses(TArray<TSubclassOf<UNavLinkDefinition>>& OutClasses) const override;
+	virtual bool GetNavigationLinksArray(TArray<FNavigationLink>& OutLink, TArray<FNavigationSegmentLink>& OutSegments) const override;
+
+	// INavRelevantInterface
+	virtual void GetNavigationData(FNavigationRelevantData& Data) const override;
+	virtual FBox GetNavigationBounds() const override;
+	virtual bool IsNavigationRelevant() const override;
+
+protected:
+	// links are searched from ground inside this box
+	UPROPERTY(VisibleAnywhere, Category = "Navigation")
+	UBoxComponent* GenerationBox;
+
+	UPROPERTY(VisibleAnywhere, Category = "Navigation")
+	TArray<FWallRunNavCell> Cells;
+
+	// all cell links in actor space, what nav mesh is built from
+	UPROPERTY()
+	TArray<FNavigationLink> PointLinks;
+
+	// grid cells were generated for, cells are dropped if box or cell size changed
+	UPROPERTY()
+	FBox CellsBox;
+
+	UPROPERTY()
+	float CellsSize;
+
+	// courses spawned at runtime have no links saved, generate them on start
+	virtual void BeginPlay() override;
+
+#if WITH_EDITOR
+	virtual void PostRegisterAllComponents() override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void BeginDestroy() override;
+	void OnActorMoved(AActor* Actor);
+	FDelegateHandle ActorMovedHandle;
+#endif
+
+	// settings used for simulation, gathered from CharacterClass once per rebuild
+	struct FSimulationSettings
+	{
+		const UWallRunComponent* WallRun = nullptr;
+		FCollisionObjectQueryParams ObjectParams;
+		FCollisionQueryParams QueryParams;
+		float RunSpeed = 600.f;
+		float CapsuleRadius = 35.f;
+		float CapsuleHalfHeight = 90.f;
+		float WorldGravityZ = -980.f;
+		float GravityScale = 1.f;
+		float WalkableFloorZ = 0.7f;
+	};
+
+	bool GetSimulationSettings(FSimulationSettings& OutSettings) const;
+
+	FBox GetCellBox(const FIntPoint& Coord) const;
+
+	// hash of everything traversals starting in the cell can touch
+	uint32 HashCellGeometry(const FWallRunNavCell& Cell, const FSimulationSettings& Settings) const;
+
+	void GenerateCell(FWallRunNavCell& Cell, const FSimulationSettings& Settings) const;
+
+	// follow the wall from touching it until falling off, adds wallrun and wall jump links
+	void SimulateWallRun(const FVector& Ground, const FVector& Contact, const FVector& InWallNormal, float Side,
+		const FSimulationSettings& Settings, TArray<FWallRunNavLink>& OutLinks) const;
+
+	// step ballistic flight until ground, false if it hits something not walkable or never lands
+	bool SimulateFall(FVector Location, FVector Velocity, const FSimulationSettings& Settings, FVector& OutLanding, float& OutTime) const;
+
+	// adds link unless it is too short, off the nav mesh or a duplicate of existing one
+	void AddLink(EWallRunTraversal Type, const FVector& Start, const FVector& End, const FVector& InWallNormal, float Duration,
+		const FSimulationSettings& Settings, TArray<FWallRunNavLink>& OutLinks) const;
+
+	// gather links of all cells into PointLinks and update nav octree
+	void UpdateNavigationLinks();
+};
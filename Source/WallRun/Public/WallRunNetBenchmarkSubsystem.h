@@ -0,0 +1,133 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunEventBus.h"
+#include "WallRunNetBenchmarkSubsystem.generated.h"
+
+class UNetConnection;
+class UNetDriver;
+struct FPacketSimulationSettings;
+
+// network conditions emulated in both directions between server and every client
+USTRUCT()
+struct FWallRunNetProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(config)
+	FName Name;
+
+	// round trip (ms), half of it is added to each direction
+	UPROPERTY(config)
+	int32 Lag = 0;
+
+	// random +- (ms) per packet and direction, reorders packets like real jitter does
+	UPROPERTY(config)
+	int32 Jitter = 0;
+
+	// percent of packets dropped in each direction
+	UPROPERTY(config)
+	int32 Loss = 0;
+};
+
+// measures how wallrun prediction holds up under lag, jitter and loss. server applies every profile through
+// net emulation, waits SettleTime, then for ProfileTime records per client: corrections/s, client position error,
+// bytes/s and how many sticks, wall jumps and climbs the scripted input (WallRun.NetBenchmarkBot on clients) did.
+// results go to Saved/Profiling/WallRun/*.csv, one row per profile and client
+UCLASS(config=Game)
+class WALLRUN_API UWallRunNetBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(config)
+	TArray<FWallRunNetProfile> Profiles;
+
+	// seconds between applying a profile and measuring, packets queued under previous profile are delivered meanwhile
+	UPROPERTY(config)
+	float SettleTime;
+
+	// default seconds measured per profile
+	UPROPERTY(config)
+	float ProfileTime;
+
+	UWallRunNetBenchmarkSubsystem();
+
+	virtual void Deinitialize() override;
+
+	// server only. runs given profiles (all if empty) in order once NumClients have a pawn,
+	// Label goes to every result row to tell builds apart
+	bool StartBenchmark(const TArray<FName>& ProfileNames, float InProfileTime, int32 NumClients, const FString& Label, bool bInExitWhenDone);
+
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+protected:
+	struct FClientSample
+	{
+		TWeakObjectPtr<UNetConnection> Connection;
+		uint32 CharacterId = 0;
+		uint32 StartOutBytes = 0;
+		uint32 StartInBytes = 0;
+		int32 NumSticks = 0;
+		int32 NumJumps = 0;
+		int32 NumClimbs = 0;
+	};
+
+	enum class EStage : uint8
+	{
+		WaitForClients,
+		Settle,
+		Measure,
+	};
+
+	TWeakObjectPtr<UNetDriver> NetDriver;
+
+	// emulation the driver had before, restored when done
+	TSharedPtr<FPacketSimulationSettings> SavedSettings;
+
+	TArray<FWallRunNetProfile> RunProfiles;
+
+	int32 ProfileIndex = 0;
+
+	EStage Stage = EStage::WaitForClients;
+
+	float StageTime = 0.f;
+
+	float RunProfileTime = 0.f;
+
+	int32 RequiredClients = 0;
+
+	FString RunLabel;
+
+	bool bExitWhenDone = false;
+
+	TArray<FClientSample> Samples;
+
+	FString Csv;
+
+	FDelegateHandle TickerHandle;
+
+	FDelegateHandle EventsHandle;
+
+	bool Tick(float DeltaTime);
+
+	void ApplyProfile(const FWallRunNetProfile& Profile);
+
+	// puts client pawns at spawn points of generated course, if there is one
+	void PlacePawns();
+
+	void BeginMeasure();
+
+	void EndMeasure();
+
+	void Finish();
+
+	void OnEvents(TArrayView<const FWallRunEvent> Events);
+
+	int32 GetNumReadyClients() const;
+};
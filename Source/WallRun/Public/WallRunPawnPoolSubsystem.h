@@ -0,0 +1,52 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunPawnPoolSubsystem.generated.h"
+
+class AWallRunCharacter;
+
+// keeps despawned characters hidden and reuses them on respawn, so respawn doesn't construct
+// capsule, camera, meshes, wallrun and movement components again and GC doesn't collect them.
+// characters aren't GC clusters: cluster references are fixed when it's created, possessed pawns keep gaining new ones
+UCLASS(config=Game)
+class WALLRUN_API UWallRunPawnPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// off - characters are spawned and destroyed as usual
+	UPROPERTY(config)
+	bool bEnabled = true;
+
+	// how many characters are spawned ahead when pawn class is loaded
+	UPROPERTY(config)
+	int32 PrewarmCount = 4;
+
+	// released characters above this count are destroyed
+	UPROPERTY(config)
+	int32 MaxPooled = 16;
+
+	// pooled character of this class or a newly spawned one, placed at SpawnTransform
+	AWallRunCharacter* AcquireCharacter(UClass* CharacterClass, const FTransform& SpawnTransform);
+
+	// unpossess and hide character until reused
+	void ReleaseCharacter(AWallRunCharacter* Character);
+
+	// spawn characters into the pool so first respawns don't spawn
+	void Prewarm(UClass* CharacterClass, int32 Count);
+
+	int32 GetNumPooled() const { return Pooled.Num(); }
+
+	virtual void Deinitialize() override;
+
+protected:
+	// hidden, waiting for reuse
+	UPROPERTY()
+	TArray<AWallRunCharacter*> Pooled;
+
+	AWallRunCharacter* SpawnCharacter(UClass* CharacterClass, const FTransform& SpawnTransform);
+};
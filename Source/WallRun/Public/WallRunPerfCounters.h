@@ -0,0 +1,96 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// per-frame counters of wallrun code, shown by AWallRunHUD overlay (wallrun.PerfOverlay 1)
+// and dumped to csv by WallRun.PerfCapture. counting is a single branch while both are off, compiled out in shipping
+#define WALLRUN_PERF_COUNTERS !UE_BUILD_SHIPPING
+
+struct FWallRunPerfFrame
+{
+	float FrameTimeMs = 0.f;
+	float WallRunTickMs = 0.f;
+	int32 NumTraces = 0;
+	int32 NumHits = 0;
+	int32 NumSticks = 0;
+	int32 NumUnsticks = 0;
+	int32 NumProjectiles = 0;
+};
+
+class WALLRUN_API FWallRunPerfCounters
+{
+public:
+	// frames kept for the overlay graph
+	static constexpr int32 HistorySize = 240;
+
+	// overlay is shown or capture is running
+	static FORCEINLINE bool IsEnabled() { return bOverlayEnabled || bCapturing; }
+
+	static bool IsOverlayEnabled() { return bOverlayEnabled; }
+
+	// counters of the frame in progress
+	static FORCEINLINE FWallRunPerfFrame& Current() { return CurrentFrame; }
+
+	// projectiles alive, counted always so the number is right when overlay is turned on
+	static int32 LiveProjectiles;
+
+	// moves current frame to history (and capture), called at the end of every frame while enabled
+	static void EndFrame();
+
+	// Age 0 - last finished frame
+	static const FWallRunPerfFrame& GetFrame(int32 Age);
+
+	static int32 GetNumFrames() { return NumFrames; }
+
+	// record every frame for Seconds, then write csv to Saved/Profiling/WallRun
+	static void StartCapture(float Seconds);
+
+	static bool IsCapturing() { return bCapturing; }
+
+private:
+	static bool bOverlayEnabled;
+	static bool bCapturing;
+	static FWallRunPerfFrame CurrentFrame;
+	static FWallRunPerfFrame History[HistorySize];
+	static int32 NextFrame;
+	static int32 NumFrames;
+	static float CaptureTimeLeft;
+	static TArray<FWallRunPerfFrame> CaptureFrames;
+
+	static void WriteCapture();
+
+	// EndFrame is hooked to engine's end of frame on first use
+	static void EnsureEndFrameHook();
+
+	friend struct FWallRunPerfOverlayCVar;
+};
+
+// adds scope duration to current frame's WallRunTickMs
+struct FWallRunPerfTickScope
+{
+	uint64 StartCycles;
+
+	FORCEINLINE FWallRunPerfTickScope()
+		: StartCycles(FWallRunPerfCounters::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	FORCEINLINE ~FWallRunPerfTickScope()
+	{
+		if (StartCycles != 0)
+		{
+			FWallRunPerfCounters::Current().WallRunTickMs += (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+};
+
+#if WALLRUN_PERF_COUNTERS
+#define WALLRUN_PERF_COUNT(Counter) do { if (FWallRunPerfCounters::IsEnabled()) { ++FWallRunPerfCounters::Current().Counter; } } while (0)
+#define WALLRUN_PERF_TICK_SCOPE() FWallRunPerfTickScope WallRunPerfTickScope
+#else
+#define WALLRUN_PERF_COUNT(Counter) do { } while (0)
+#define WALLRUN_PERF_TICK_SCOPE()
+#endif
@@ -0,0 +1,131 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunProjectileSubsystem.generated.h"
+
+class AWallRunCharacter;
+class AWallRunProjectile;
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FWallRunCharacterHitDelegate, AWallRunCharacter* /* Shooter */, AWallRunCharacter* /* Target */, const FVector& /* Location */);
+
+// one shot as it is sent over network, every machine simulates projectile from it
+USTRUCT()
+struct WALLRUN_API FWallRunFireEvent
+{
+	GENERATED_BODY()
+
+	// muzzle location, 0.1 cm precision on wire
+	UPROPERTY()
+	FVector Origin = FVector::ZeroVector;
+
+	// aim, 16 bit per axis on wire
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	// server world time the shooter fired at
+	UPROPERTY()
+	float Timestamp = 0.f;
+
+	// spread seed, also identifies the shot among shooter's shots for impact corrections
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	// rounds origin and rotation the way NetSerialize does, so shooter simulates same values as everyone else
+	void Quantize();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FWallRunFireEvent> : public TStructOpsTypeTraitsBase2<FWallRunFireEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// where authoritative projectile ended, sent to clients to correct their simulation
+USTRUCT()
+struct WALLRUN_API FWallRunProjectileImpact
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Normal;
+};
+
+// spawns projectiles from fire events and matches impact corrections to locally simulated ones.
+// wallrun.ProjectileReplication 0 switches back to one replicated actor per projectile for comparison
+UCLASS(config=Game)
+class WALLRUN_API UWallRunProjectileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// seeded random cone half angle (degrees) applied to every shot
+	UPROPERTY(config)
+	float SpreadAngle = 0.f;
+
+	// late projectiles (remote shots, server) are simulated forward by shot age, up to this many seconds
+	UPROPERTY(config)
+	float MaxCatchUpTime = 0.25f;
+
+	// step of forward simulation
+	UPROPERTY(config)
+	float CatchUpStep = 1.f / 60.f;
+
+	// fire events instead of replicated projectile actors
+	static bool UseFireEvents();
+
+	// time shots are stamped with, same on server and clients
+	float GetServerTime() const;
+
+	// fire event for a shot from Origin towards Rotation, with next seed of the shooter
+	FWallRunFireEvent MakeFireEvent(const FVector& Origin, const FRotator& Rotation, uint16 Seed) const;
+
+	/**
+	 * Spawns projectile for a shot.
+	 * @param	bAuthoritative	server projectile, its impacts are sent to clients
+	 * @param	bReplicated		replicated actor (baseline path), otherwise local only
+	 * @param	bCatchUp		simulate forward by the age of the shot
+	 */
+	AWallRunProjectile* SpawnProjectile(AWallRunCharacter* Shooter, UClass* ProjectileClass, const FWallRunFireEvent& Event, bool bAuthoritative, bool bReplicated, bool bCatchUp);
+
+	// server: authoritative projectile hit something and is destroyed
+	void OnProjectileImpact(AWallRunProjectile* Projectile, const FHitResult& Hit);
+
+	// server: segment projectile moved along against characters rewound to the time its shooter saw them
+	// (UWallRunLagCompensationSubsystem). on hit projectile stops at the rewound capsule and is destroyed
+	bool TraceRewound(AWallRunProjectile* Projectile, const FVector& Start, const FVector& End);
+
+	// server: lag compensated hit of a character, for damage and other gameplay
+	FWallRunCharacterHitDelegate OnCharacterHit;
+
+	// client: move local projectile of the shot to authoritative impact and destroy it
+	void ApplyImpact(const AWallRunCharacter* Shooter, const FWallRunProjectileImpact& Impact);
+
+	void OnProjectileEndPlay(AWallRunProjectile* Projectile);
+
+	// counters for WallRun.BenchmarkProjectileNet
+	int32 NumShots = 0;
+	int32 NumImpacts = 0;
+	int32 NumCharacterHits = 0;
+
+protected:
+	static uint64 MakeShotKey(const AActor* Shooter, uint16 Seed);
+
+	// locally simulated projectiles by shooter and seed
+	TMap<uint64, TWeakObjectPtr<AWallRunProjectile>> Projectiles;
+};
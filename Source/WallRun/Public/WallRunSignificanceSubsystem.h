@@ -0,0 +1,88 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunSignificanceSubsystem.generated.h"
+
+class AWallRunCharacter;
+
+// how much work a character gets at some distance from viewers
+USTRUCT()
+struct FWallRunSignificanceTier
+{
+	GENERATED_BODY()
+
+	// characters closer than this (to the closest viewer) use this tier
+	UPROPERTY(config)
+	float MaxDistance = 0.f;
+
+	// UWallRunComponent tick interval, 0 - every frame
+	UPROPERTY(config)
+	float TickInterval = 0.f;
+
+	// wall edge trace interval
+	UPROPERTY(config)
+	float WallTraceInterval = 0.f;
+
+	// skeletal meshes tick interval (animation update rate)
+	UPROPERTY(config)
+	float AnimTickInterval = 0.f;
+
+	UPROPERTY(config)
+	bool bAudio = true;
+};
+
+struct FWallRunSignificanceTickFunction : public FTickFunction
+{
+	class UWallRunSignificanceSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override { return TEXT("WallRunSignificance"); }
+};
+
+// scores remote characters by distance and visibility to local viewers and reduces
+// wallrun tick rate, wall traces, animation rate and audio of the insignificant ones.
+// only simulated proxies are affected, their wallrun state is cosmetic - server and owning client run it at full rate
+UCLASS(config=Game)
+class WALLRUN_API UWallRunSignificanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// tiers from most to least significant, last one is used for everything further
+	UPROPERTY(config)
+	TArray<FWallRunSignificanceTier> Tiers;
+
+	// how often (seconds) significance is recalculated
+	UPROPERTY(config)
+	float UpdateInterval = 0.25f;
+
+	// characters not rendered recently are moved one tier down
+	UPROPERTY(config)
+	bool bUseVisibility = true;
+
+	void RegisterCharacter(AWallRunCharacter* Character);
+
+	void UnregisterCharacter(AWallRunCharacter* Character);
+
+	void Update();
+
+	// tier of character, 0 if not managed
+	int32 GetTier(const AWallRunCharacter* Character) const;
+
+protected:
+	UPROPERTY()
+	TArray<AWallRunCharacter*> Characters;
+
+	TArray<int32> CharacterTiers;
+
+	FWallRunSignificanceTickFunction TickFunction;
+
+	void ApplyTier(AWallRunCharacter* Character, int32 Tier);
+};
@@ -0,0 +1,56 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WallRunEventBus.h"
+#include "WallRunTelemetrySubsystem.generated.h"
+
+class FRunnableThread;
+
+// one event as written to telemetry files (little endian, 22 bytes before compression)
+struct FWallRunTelemetryRecord
+{
+	uint8 Type = 0;
+	uint8 Reason = 0;
+	uint32 CharacterId = 0;
+	float Time = 0.f;
+	FVector Location = FVector::ZeroVector;
+
+	friend FArchive& operator<<(FArchive& Ar, FWallRunTelemetryRecord& Record)
+	{
+		Ar << Record.Type << Record.Reason << Record.CharacterId << Record.Time;
+		Ar << Record.Location.X << Record.Location.Y << Record.Location.Z;
+		return Ar;
+	}
+
+	// telemetry chunk file: Magic, uncompressed size, compressed size (int32), then zlib compressed records
+	static constexpr uint32 ChunkMagic = 0x31525457; // "WTR1"
+	static const TCHAR* GetFileExtension() { return TEXT(".wrt"); }
+};
+
+// writes wallrun events (stick, unstick with reason, wall jump, ledge climb and failed climb, land) to compressed chunk files
+// on its own thread; game thread only copies events into a queue (see UWallRunEventBus)
+// enable with wallrun.Telemetry 1 (before map load) or -WallRunTelemetry, files go to Saved/Telemetry
+UCLASS()
+class WALLRUN_API UWallRunTelemetrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+protected:
+	UPROPERTY()
+	UWallRunEventBus* EventBus;
+
+	TSharedPtr<FWallRunEventQueue, ESPMode::ThreadSafe> Queue;
+
+	TUniquePtr<class FWallRunTelemetryWriter> Writer;
+
+	FRunnableThread* WriterThread = nullptr;
+};
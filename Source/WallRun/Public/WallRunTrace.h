@@ -0,0 +1,41 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "WallRunFeatures.h"
+
+struct FWallRunEvent;
+
+// "WallRun" trace channel: wallrun state changes for Unreal Insights (WallRunInsights module draws per-character timelines).
+// enable with -trace=cpu,wallrun (works with -nullrhi servers and -tracefile) or "Trace.Enable WallRun" at runtime.
+// while the channel is off, tracing is one branch
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING && WALLRUN_WITH_TELEMETRY
+#define WALLRUN_TRACE_ENABLED 1
+#else
+#define WALLRUN_TRACE_ENABLED 0
+#endif
+
+#if WALLRUN_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(WallRunChannel, WALLRUN_API);
+
+struct WALLRUN_API FWallRunTrace
+{
+	// Event.Type and Reason are sent as EWallRunEventType / EWallRunOffWallReason values
+	static void OutputStateChange(const FWallRunEvent& Event, const AActor* Character);
+};
+
+#define TRACE_WALLRUN_STATE_CHANGE(Event, Character) \
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(WallRunChannel)) \
+	{ \
+		FWallRunTrace::OutputStateChange(Event, Character); \
+	}
+
+#else
+
+#define TRACE_WALLRUN_STATE_CHANGE(Event, Character)
+
+#endif
@@ -3,5 +3,10 @@
 #include "WallRun.h"
 #include "Modules/ModuleManager.h"
 
+LLM_DEFINE_TAG(WallRun_Characters);
+LLM_DEFINE_TAG(WallRun_Components);
+LLM_DEFINE_TAG(WallRun_Projectiles);
+LLM_DEFINE_TAG(WallRun_Audio);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, WallRun, "WallRun" );
  
\ No newline at end of file
@@ -3,3 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// stats shown with "stat WallRun"
+DECLARE_STATS_GROUP(TEXT("WallRun"), STATGROUP_WallRun, STATCAT_Advanced);
+
+// memory tags shown with "stat LLM" / "stat LLMFULL" (run with -LLM)
+LLM_DECLARE_TAG_API(WallRun_Characters, WALLRUN_API);
+LLM_DECLARE_TAG_API(WallRun_Components, WALLRUN_API);
+LLM_DECLARE_TAG_API(WallRun_Projectiles, WALLRUN_API);
+LLM_DECLARE_TAG_API(WallRun_Audio, WALLRUN_API);
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WallRunCharacter.h"
+#include "WallRun.h"
 
 #include "WallCharacterMovementComponent.h"
 #include "WallRunProjectile.h"
@@ -11,8 +12,12 @@
 #include "GameFramework/InputSettings.h"
 #include "Kismet/GameplayStatics.h"
 #include "WallRunComponent.h"
+#include "WallRunAudioSubsystem.h"
+#include "WallRunLagCompensationSubsystem.h"
+#include "WallRunSignificanceSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "Engine/AssetManager.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
@@ -22,6 +27,8 @@ DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 AWallRunCharacter::AWallRunCharacter(const FObjectInitializer& ObjectInitializer)
 : Super(ObjectInitializer.SetDefaultSubobjectClass<UWallCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
+	LLM_SCOPE_BYTAG(WallRun_Characters);
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
 
@@ -74,6 +81,12 @@ AWallRunCharacter::AWallRunCharacter(const FObjectInitializer& ObjectInitializer
 	CrouchSpeed = 200.f;
 	bCrouchDisabled = false;
 
+	HistoryRate = 60.f;
+	NextShotSeed = 0;
+	NextAuthorityShotSeed = 0;
+	bPooled = false;
+	bInPool = false;
+
 }
 
 void AWallRunCharacter::BeginPlay()
@@ -83,6 +96,139 @@ void AWallRunCharacter::BeginPlay()
 
 	//Attach gun mesh component to Skeleton, doing it here because the skeleton is not yet created in the constructor
 	FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
+
+	PreloadAssets();
+
+	// only server validates hits
+	if (HasAuthority())
+	{
+		const UWallRunLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UWallRunLagCompensationSubsystem>();
+		const float MaxRewindTime = LagCompensation ? LagCompensation->MaxRewindTime : 1.f;
+		// +2 so interpolation still has a sample on both sides of the oldest allowed time
+		History.Init(FMath::CeilToInt(MaxRewindTime * FMath::Max(HistoryRate, 1.f)) + 2);
+	}
+	if (!bInPool)
+	{
+		RegisterWithSubsystems();
+	}
+}
+
+void AWallRunCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromSubsystems();
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWallRunCharacter::RegisterWithSubsystems()
+{
+	if (HasAuthority())
+	{
+		if (UWallRunLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UWallRunLagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+
+	if (UWallRunSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UWallRunSignificanceSubsystem>())
+	{
+		Significance->RegisterCharacter(this);
+	}
+}
+
+void AWallRunCharacter::UnregisterFromSubsystems()
+{
+	if (UWallRunLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UWallRunLagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+	if (UWallRunSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UWallRunSignificanceSubsystem>())
+	{
+		Significance->UnregisterCharacter(this);
+	}
+}
+
+void AWallRunCharacter::OnReleasedToPool()
+{
+	bInPool = true;
+	UnregisterFromSubsystems();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	if (WallRunComp)
+	{
+		WallRunComp->ResetWallRunState();
+	}
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	// stand up instantly, next owner must not start crouched
+	bWantsToCrouch = false;
+	bIsCrouched = false;
+	GetCapsuleComponent()->SetCapsuleHalfHeight(StandHalfHeight, false);
+	const FVector CameraLocation = GetFirstPersonCameraComponent()->GetRelativeLocation();
+	GetFirstPersonCameraComponent()->SetRelativeLocation(FVector(CameraLocation.X, CameraLocation.Y, StandCameraOffset));
+	History.Reset();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	// actor tick doesn't cover components: meshes, movement and wallrun would keep ticking in the pool
+	for (UActorComponent* Component : GetComponents())
+	{
+		Component->SetComponentTickEnabled(false);
+	}
+	// last hidden state goes to clients, then nothing is replicated until reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AWallRunCharacter::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+	bInPool = false;
+	FlushNetDormancy();
+	SetNetDormancy(DORM_Awake);
+
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	// only what ticked when spawned, components that start disabled enable their tick themselves
+	for (UActorComponent* Component : GetComponents())
+	{
+		if (Component->PrimaryComponentTick.bStartWithTickEnabled)
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	RegisterWithSubsystems();
+}
+
+void AWallRunCharacter::PreloadAssets()
+{
+	TArray<FSoftObjectPath> AssetsToLoad;
+	GetAssetsToPreload(GetNetMode() != NM_DedicatedServer, AssetsToLoad);
+	// skip already loaded (e.g. preloaded by game mode)
+	AssetsToLoad.RemoveAll([](const FSoftObjectPath& Path) { return Path.ResolveObject() != nullptr; });
+	if (AssetsToLoad.Num() > 0)
+	{
+		PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad);
+	}
+}
+
+void AWallRunCharacter::GetAssetsToPreload(bool bCosmetic, TArray<FSoftObjectPath>& OutAssets) const
+{
+	OutAssets.Add(ProjectileClass.ToSoftObjectPath());
+	if (bCosmetic)
+	{
+		OutAssets.Add(FireSound.ToSoftObjectPath());
+		OutAssets.Add(JumpSound.ToSoftObjectPath());
+		OutAssets.Add(FireAnimation.ToSoftObjectPath());
+		if (WallRunComp)
+		{
+			OutAssets.Add(WallRunComp->WallRunSound.ToSoftObjectPath());
+		}
+	}
+	OutAssets.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
 }
 
 void AWallRunCharacter::Tick(float DeltaTime)
@@ -90,6 +236,22 @@ void AWallRunCharacter::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 
 	UpdateCrouch(DeltaTime);
+
+	// fixed rate, so buffer covers the same time at any server tick rate
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (HasAuthority() && (History.Num() == 0 || Now - History.GetNewestTime() >= 1.f / FMath::Max(HistoryRate, 1.f) - KINDA_SMALL_NUMBER))
+	{
+		History.Record(Now, GetActorLocation(), GetActorQuat(), GetCapsuleComponent()->GetScaledCapsuleHalfHeight(),
+			WallRunComp && WallRunComp->bOnWall);
+	}
+
+	// jump pressed shortly before reaching the wall
+	if (WallRunComp && WallRunComp->ConsumeBufferedJump())
+	{
+		if (JumpSound)
+			UWallRunAudioSubsystem::PlaySound2D(this, JumpSound.Get());
+		WallRunComp->WallJump();
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -136,9 +298,10 @@ void AWallRunCharacter::Crouch(bool bClientSimulation /* = false */)
 	{
 		if (WallRunComp->bOnWall)
 		{
-			WallRunComp->OffWall();
+			WallRunComp->OffWall(EWallRunOffWallReason::Crouch);
 			return;
 		}
+		WallRunComp->BufferDetach();
 	}			
 	bWantsToCrouch = !(bWantsToCrouch);
 }
@@ -202,62 +365,173 @@ void AWallRunCharacter::Jump()
 	{
 		Super::Jump();
 		if (JumpSound && CanJump())
-			UGameplayStatics::PlaySound2D(this, JumpSound);
+			UWallRunAudioSubsystem::PlaySound2D(this, JumpSound.Get());
 		return;
 	}
 	if (WallRunComp->bCanJumpFromWall)
 	{
 		if (JumpSound)
-			UGameplayStatics::PlaySound2D(this, JumpSound);
+			UWallRunAudioSubsystem::PlaySound2D(this, JumpSound.Get());
 		WallRunComp->WallJump();
 	}
 	else
+	{
+		// wall reached within InputBufferTime still gets wall jump (see Tick)
+		WallRunComp->BufferJump();
 		if (JumpSound && CanJump())
-			UGameplayStatics::PlaySound2D(this, JumpSound);
-		Super::Jump();
+			UWallRunAudioSubsystem::PlaySound2D(this, JumpSound.Get());
+	}
+	Super::Jump();
+}
+
+void AWallRunCharacter::GetMuzzle(FVector& OutLocation, FRotator& OutRotation) const
+{
+	OutRotation = GetControlRotation();
+	// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
+	OutLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + OutRotation.RotateVector(GunOffset);
 }
 
 void AWallRunCharacter::OnFire()
 {
 	// try and fire a projectile
-	if (ProjectileClass != nullptr)
+	// projectile is gameplay relevant, so load it now if async preload isn't finished yet
+	UClass* const Projectile = ProjectileClass.IsNull() ? nullptr : ProjectileClass.LoadSynchronous();
+	UWallRunProjectileSubsystem* const Projectiles = GetWorld() ? GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>() : nullptr;
+	if (Projectile != nullptr && Projectiles != nullptr)
 	{
-		UWorld* const World = GetWorld();
-		if (World != nullptr)
-		{
-				const FRotator SpawnRotation = GetControlRotation();
-				// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
-				const FVector SpawnLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + SpawnRotation.RotateVector(GunOffset);
+		FVector SpawnLocation;
+		FRotator SpawnRotation;
+		GetMuzzle(SpawnLocation, SpawnRotation);
+		const FWallRunFireEvent Event = Projectiles->MakeFireEvent(SpawnLocation, SpawnRotation, NextShotSeed++ & ClientSeedMask);
 
-				//Set Spawn Collision Handling Override
-				FActorSpawnParameters ActorSpawnParams;
-				ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
-
-				// spawn the projectile at the muzzle
-				World->SpawnActor<AWallRunProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+		if (GetNetMode() == NM_Standalone)
+		{
+			Projectiles->SpawnProjectile(this, Projectile, Event, true, false, false);
+		}
+		else if (HasAuthority())
+		{
+			SpawnServerShot(Event);
+		}
+		else
+		{
+			// predicted copy, server corrects its impact. with replicated actors server projectile is the only one
+			if (UWallRunProjectileSubsystem::UseFireEvents())
+			{
+				Projectiles->SpawnProjectile(this, Projectile, Event, false, false, false);
+			}
+			ServerFire(Event);
 		}
 	}
 
-	// try and play the sound if specified
-	if (FireSound != nullptr)
+	// try and play the sound if specified (and already loaded)
+	if (FireSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+		UWallRunAudioSubsystem::PlaySoundAtLocation(this, FireSound.Get(), GetActorLocation());
 	}
 
-	// try and play a firing animation if specified
-	if (FireAnimation != nullptr)
+	// try and play a firing animation if specified (and already loaded)
+	if (FireAnimation)
 	{
 		// Get the animation object for the arms mesh
 		UAnimInstance* AnimInstance = Mesh1P->GetAnimInstance();
 		if (AnimInstance != nullptr)
 		{
-			AnimInstance->Montage_Play(FireAnimation, 1.f);
+			AnimInstance->Montage_Play(FireAnimation.Get(), 1.f);
 		}
 	}
 }
 
 
 
+void AWallRunCharacter::ServerFire_Implementation(const FWallRunFireEvent& Event)
+{
+	// generous, muzzle is a bit ahead of the camera and client position lags a little.
+	// late or lost moves can put client far off for a moment, that loses the shot, not the connection
+	if (FVector::DistSquared(Event.Origin, GetActorLocation()) >= FMath::Square(1000.f))
+	{
+		UE_LOG(LogFPChar, Verbose, TEXT("%s: shot %u dropped, origin too far from character"), *GetName(), Event.Seed);
+		return;
+	}
+	// server shots own the other half of seeds
+	if (Event.Seed & AuthoritySeedFlag)
+	{
+		UE_LOG(LogFPChar, Verbose, TEXT("%s: shot %u dropped, seed out of client range"), *GetName(), Event.Seed);
+		return;
+	}
+	SpawnServerShot(Event);
+}
+
+void AWallRunCharacter::SpawnServerShot(const FWallRunFireEvent& Event)
+{
+	// no loading inside a shot, class is preloaded on BeginPlay; until it is there shots are dropped
+	UClass* const Projectile = ProjectileClass.Get();
+	UWallRunProjectileSubsystem* const Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>();
+	if (Projectile == nullptr && !ProjectileClass.IsNull())
+	{
+		UE_LOG(LogFPChar, Verbose, TEXT("%s: shot %u dropped, projectile class not loaded yet"), *GetName(), Event.Seed);
+	}
+	if (Projectile == nullptr || Projectiles == nullptr)
+	{
+		return;
+	}
+
+	if (UWallRunProjectileSubsystem::UseFireEvents())
+	{
+		// one record on this character's channel, no actor channel per projectile
+		Projectiles->SpawnProjectile(this, Projectile, Event, true, false, !IsLocallyControlled());
+		MulticastFire(Event);
+	}
+	else
+	{
+		Projectiles->SpawnProjectile(this, Projectile, Event, true, true, false);
+	}
+}
+
+void AWallRunCharacter::MulticastFire_Implementation(const FWallRunFireEvent& Event)
+{
+	// server and shooter spawned theirs already
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		return;
+	}
+
+	UClass* const Projectile = ProjectileClass.Get();
+	if (UWallRunProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>())
+	{
+		// not loaded yet on this client means missed cosmetic shot, better than a hitch
+		Projectiles->SpawnProjectile(this, Projectile, Event, false, false, true);
+	}
+	if (FireSound)
+	{
+		UWallRunAudioSubsystem::PlaySoundAtLocation(this, FireSound.Get(), Event.Origin);
+	}
+}
+
+void AWallRunCharacter::MulticastProjectileImpact_Implementation(const FWallRunProjectileImpact& Impact)
+{
+	if (HasAuthority())
+	{
+		return;
+	}
+	if (UWallRunProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>())
+	{
+		Projectiles->ApplyImpact(this, Impact);
+	}
+}
+
+void AWallRunCharacter::AuthorityFire()
+{
+	UWallRunProjectileSubsystem* const Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>();
+	if (!HasAuthority() || Projectiles == nullptr)
+	{
+		return;
+	}
+	FVector SpawnLocation;
+	FRotator SpawnRotation;
+	GetMuzzle(SpawnLocation, SpawnRotation);
+	SpawnServerShot(Projectiles->MakeFireEvent(SpawnLocation, SpawnRotation, AuthoritySeedFlag | (NextAuthorityShotSeed++ & ClientSeedMask)));
+}
+
 void AWallRunCharacter::MoveForward(float Value)
 {
 	if (!WallRunComp) 
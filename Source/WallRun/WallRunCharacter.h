@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "WallRunHistory.h"
+#include "WallRunProjectileSubsystem.h"
 #include "WallRunCharacter.generated.h"
 
 class UInputComponent;
@@ -14,6 +16,7 @@ class UMotionControllerComponent;
 class UAnimMontage;
 class USoundBase;
 class UWallRunComponent;
+struct FStreamableHandle;
 
 UCLASS(config=Game)
 class AWallRunCharacter : public ACharacter
@@ -57,10 +60,25 @@ public:
 protected:
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void Tick(float DeltaTime) override;
 	
 	void UpdateCrouch(float DeltaSeconds);
 
+	/** Starts async loading of soft referenced sounds, animation and projectile (if game mode didn't preload them yet) */
+	void PreloadAssets();
+
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** Recent capsule transforms and wallrun state, recorded on server for lag compensation */
+	FWallRunHistory History;
+
+	/** Lag compensation and significance, on BeginPlay and when taken out of pool */
+	void RegisterWithSubsystems();
+
+	void UnregisterFromSubsystems();
+
 public:
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
@@ -76,18 +94,18 @@ public:
 
 	/** Projectile class to spawn */
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
-	TSubclassOf<class AWallRunProjectile> ProjectileClass;
+	TSoftClassPtr<class AWallRunProjectile> ProjectileClass;
 
 	/** Sound to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
-	USoundBase* FireSound;
+	TSoftObjectPtr<USoundBase> FireSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	USoundBase* JumpSound;
+	TSoftObjectPtr<USoundBase> JumpSound;
 
 	/** AnimMontage to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	UAnimMontage* FireAnimation;
+	TSoftObjectPtr<UAnimMontage> FireAnimation;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 	float CrouchHalfHeight;
@@ -110,11 +128,38 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = Gameplay)
 	bool bWantsToCrouch;
 
+	/** How often (Hz) server records history for lag compensation, buffer holds MaxRewindTime of it whatever the tick rate is */
+	UPROPERTY(EditDefaultsOnly, Category = LagCompensation, meta = (ClampMin = "1"))
+	float HistoryRate;
+
 protected:
 	
 	/** Fires a projectile. */
 	void OnFire();
 
+	/** Client shot: server checks it and spawns its projectile, shots that don't pass are dropped without kicking the client */
+	UFUNCTION(Server, Reliable)
+	void ServerFire(const FWallRunFireEvent& Event);
+
+	/** Spawns server projectile for the shot and replicates it (fire event or replicated actor, see wallrun.ProjectileReplication) */
+	void SpawnServerShot(const FWallRunFireEvent& Event);
+
+	/** Other clients simulate the shot locally */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFire(const FWallRunFireEvent& Event);
+
+	/** Muzzle location and aim of a shot fired now */
+	void GetMuzzle(FVector& OutLocation, FRotator& OutRotation) const;
+
+	/** Seed of the next shot, identifies it in impact corrections. Shots of the player use ClientSeedMask range */
+	uint16 NextShotSeed;
+
+	/** Seed of the next shot server fires on its own (AuthorityFire), kept apart so it never matches a player's shot */
+	uint16 NextAuthorityShotSeed;
+
+	static constexpr uint16 ClientSeedMask = 0x7fff;
+	static constexpr uint16 AuthoritySeedFlag = 0x8000;
+
 	/** Resets HMD orientation and position in VR. */
 	void OnResetVR();
 
@@ -150,6 +195,27 @@ public:
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
+	/** Returns recorded history (empty on clients) **/
+	const FWallRunHistory& GetHistory() const { return History; }
+
+	/** Authoritative projectile of a shot ended, clients correct their simulated copy */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastProjectileImpact(const FWallRunProjectileImpact& Impact);
+
+	/** Server: fires from current aim as if ServerFire arrived (bots, benchmarks) */
+	void AuthorityFire();
+
+	/** Puts character to pawn pool: hidden, without collision and tick, wallrun and crouch state reset */
+	void OnReleasedToPool();
+
+	/** Takes character out of pawn pool at given transform, ready to be possessed */
+	void OnAcquiredFromPool(const FTransform& SpawnTransform);
+
+	/** Created by UWallRunPawnPoolSubsystem */
+	bool bPooled;
+
+	/** Hidden in pawn pool (may be before BeginPlay if pool was prewarmed during level load) */
+	bool bInPool;
 
 	//UFUNCTION(BlueprintCallable, Category = Character)
 	//bool CanJump() const override;
@@ -159,5 +225,11 @@ public:
 
 	virtual void Jump() override;
 
+	/**
+	 * Collects soft referenced assets this character needs.
+	 * @param bCosmetic	include sounds and animations (not needed on dedicated server)
+	 */
+	void GetAssetsToPreload(bool bCosmetic, TArray<FSoftObjectPath>& OutAssets) const;
+
 };
 
@@ -1,17 +1,145 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WallRunGameMode.h"
+#include "WallRun.h"
 #include "WallRunHUD.h"
 #include "WallRunCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "WallRunPawnPoolSubsystem.h"
+#include "Engine/AssetManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWallRunLoading, Log, All);
 
 AWallRunGameMode::AWallRunGameMode()
 	: Super()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter"));
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	// set default pawn class to our Blueprinted character (loaded in InitGame)
+	PlayerPawnClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter.FirstPersonCharacter_C")));
 
 	// use our custom HUD class
 	HUDClass = AWallRunHUD::StaticClass();
+
+	InitGameTime = 0.0;
+}
+
+void AWallRunGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	InitGameTime = FPlatformTime::Seconds();
+	UE_LOG(LogWallRunLoading, Log, TEXT("InitGame %s: %.3f s since process start"), *MapName, InitGameTime - GStartTime);
+
+	// start loading pawn class while the rest of the map is initialized
+	if (!PlayerPawnClass.IsNull())
+	{
+		PawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PlayerPawnClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &AWallRunGameMode::OnPawnClassLoaded));
+	}
+}
+
+void AWallRunGameMode::OnPawnClassLoaded()
+{
+	UClass* const PawnClass = PlayerPawnClass.Get();
+	if (PawnClass == nullptr)
+	{
+		UE_LOG(LogWallRunLoading, Warning, TEXT("Failed to load pawn class %s"), *PlayerPawnClass.ToString());
+		return;
+	}
+	UE_LOG(LogWallRunLoading, Log, TEXT("Pawn class loaded in %.3f s"), FPlatformTime::Seconds() - InitGameTime);
+
+	// second phase - assets soft referenced by the pawn, cosmetic ones are not needed on dedicated server
+	TArray<FSoftObjectPath> AssetsToLoad;
+	if (const AWallRunCharacter* Character = Cast<AWallRunCharacter>(PawnClass->GetDefaultObject()))
+	{
+		Character->GetAssetsToPreload(GetNetMode() != NM_DedicatedServer, AssetsToLoad);
+	}
+	if (AssetsToLoad.Num() > 0)
+	{
+		PawnAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad,
+			FStreamableDelegate::CreateUObject(this, &AWallRunGameMode::OnPawnAssetsLoaded));
+	}
+	else
+	{
+		OnPawnAssetsLoaded();
+	}
+}
+
+void AWallRunGameMode::OnPawnAssetsLoaded()
+{
+	UE_LOG(LogWallRunLoading, Log, TEXT("Pawn assets loaded in %.3f s"), FPlatformTime::Seconds() - InitGameTime);
+
+	// pawns for first respawns, spawned while nobody plays yet
+	if (UWallRunPawnPoolSubsystem* Pool = GetWorld()->GetSubsystem<UWallRunPawnPoolSubsystem>())
+	{
+		Pool->Prewarm(PlayerPawnClass.Get(), Pool->PrewarmCount);
+	}
+}
+
+void AWallRunGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	UE_LOG(LogWallRunLoading, Log, TEXT("StartPlay: %.3f s after InitGame, %.3f s since process start"),
+		FPlatformTime::Seconds() - InitGameTime, FPlatformTime::Seconds() - GStartTime);
+}
+
+UClass* AWallRunGameMode::GetDefaultPawnClassForController_Implementation(AController* InController)
+{
+	if (!PlayerPawnClass.IsNull())
+	{
+		// player spawned before async load finished - have to wait for it
+		if (PlayerPawnClass.IsPending())
+		{
+			const double StallStartTime = FPlatformTime::Seconds();
+			PlayerPawnClass.LoadSynchronous();
+			UE_LOG(LogWallRunLoading, Warning, TEXT("Waited %.3f s for pawn class to load"), FPlatformTime::Seconds() - StallStartTime);
+		}
+		if (UClass* const PawnClass = PlayerPawnClass.Get())
+		{
+			return PawnClass;
+		}
+	}
+	return Super::GetDefaultPawnClassForController_Implementation(InController);
+}
+
+APawn* AWallRunGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	// actor, components, physics, anim instances and render state of the pawn are created here, not in its constructor
+	LLM_SCOPE_BYTAG(WallRun_Characters);
+	UClass* const PawnClass = GetDefaultPawnClassForController(NewPlayer);
+	UWallRunPawnPoolSubsystem* Pool = GetWorld()->GetSubsystem<UWallRunPawnPoolSubsystem>();
+	if (Pool && Pool->bEnabled && PawnClass && PawnClass->IsChildOf(AWallRunCharacter::StaticClass()))
+	{
+		if (AWallRunCharacter* Character = Pool->AcquireCharacter(PawnClass, SpawnTransform))
+		{
+			Character->SetInstigator(GetInstigator());
+			return Character;
+		}
+	}
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+void AWallRunGameMode::RespawnPlayer(AController* Controller)
+{
+	if (!Controller)
+	{
+		return;
+	}
+	APawn* OldPawn = Controller->GetPawn();
+	UWallRunPawnPoolSubsystem* Pool = GetWorld()->GetSubsystem<UWallRunPawnPoolSubsystem>();
+	if (AWallRunCharacter* Character = Cast<AWallRunCharacter>(OldPawn))
+	{
+		if (Pool)
+		{
+			Pool->ReleaseCharacter(Character);
+		}
+		else
+		{
+			Character->Destroy();
+		}
+	}
+	else if (OldPawn)
+	{
+		OldPawn->Destroy();
+	}
+	RestartPlayer(Controller);
 }
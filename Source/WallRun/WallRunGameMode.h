@@ -6,13 +6,46 @@
 #include "GameFramework/GameModeBase.h"
 #include "WallRunGameMode.generated.h"
 
-UCLASS(minimalapi)
+struct FStreamableHandle;
+
+UCLASS(minimalapi, config=Game)
 class AWallRunGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
 public:
 	AWallRunGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void StartPlay() override;
+
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+	/** Takes character from pawn pool instead of spawning a new one */
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+	/** Returns controller's pawn to the pool and restarts player at a player start */
+	UFUNCTION(BlueprintCallable, Category = Game)
+	void RespawnPlayer(AController* Controller);
+
+protected:
+	/** Blueprinted character, soft referenced so game mode class doesn't load it; loaded async in InitGame */
+	UPROPERTY(config, EditDefaultsOnly, Category = Classes)
+	TSoftClassPtr<APawn> PlayerPawnClass;
+
+	/** Called when pawn class is loaded, starts loading assets it references */
+	void OnPawnClassLoaded();
+
+	/** Called when assets referenced by pawn class defaults are loaded */
+	void OnPawnAssetsLoaded();
+
+	TSharedPtr<FStreamableHandle> PawnClassHandle;
+
+	TSharedPtr<FStreamableHandle> PawnAssetsHandle;
+
+	/** Time InitGame started, for load time logging */
+	double InitGameTime;
 };
 
 
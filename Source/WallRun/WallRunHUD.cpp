@@ -5,13 +5,22 @@
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "CanvasItem.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "RenderUtils.h"
+#include "WallRunPerfCounters.h"
 
 AWallRunHUD::AWallRunHUD()
 {
-	// Set the crosshair texture
-	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
-	CrosshairTex = CrosshairTexObj.Object;
+	// Set the crosshair texture (soft reference, so HUD class doesn't load it)
+	CrosshairTex = TSoftObjectPtr<UTexture2D>(FSoftObjectPath(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair.FirstPersonCrosshair")));
+}
+
+void AWallRunHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CrosshairHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(CrosshairTex.ToSoftObjectPath());
 }
 
 
@@ -19,6 +28,18 @@ void AWallRunHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
+	if (FWallRunPerfCounters::IsOverlayEnabled())
+	{
+		DrawPerfOverlay();
+	}
+
+	// crosshair is not loaded yet
+	UTexture2D* const Crosshair = CrosshairTex.Get();
+	if (Crosshair == nullptr)
+	{
+		return;
+	}
+
 	// Draw very simple crosshair
 
 	// find center of the Canvas
@@ -29,7 +50,92 @@ void AWallRunHUD::DrawHUD()
 										   (Center.Y + 20.0f));
 
 	// draw the crosshair
-	FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
+	FCanvasTileItem TileItem( CrosshairDrawPosition, Crosshair->Resource, FLinearColor::White);
 	TileItem.BlendMode = SE_BLEND_Translucent;
 	Canvas->DrawItem( TileItem );
 }
+
+void AWallRunHUD::DrawPerfOverlay()
+{
+	const int32 NumFrames = FWallRunPerfCounters::GetNumFrames();
+	if (NumFrames == 0)
+	{
+		return;
+	}
+
+	const FVector2D Origin(20.f, 60.f);
+	const FVector2D GraphSize(FWallRunPerfCounters::HistorySize * 2.f, 80.f);
+
+	// averages and peaks over the history, graph scale follows the peak
+	FWallRunPerfFrame Sum;
+	float PeakTickMs = 0.f;
+	int32 PeakTraces = 0;
+	for (int32 Age = 0; Age < NumFrames; ++Age)
+	{
+		const FWallRunPerfFrame& Frame = FWallRunPerfCounters::GetFrame(Age);
+		Sum.FrameTimeMs += Frame.FrameTimeMs;
+		Sum.WallRunTickMs += Frame.WallRunTickMs;
+		Sum.NumTraces += Frame.NumTraces;
+		Sum.NumHits += Frame.NumHits;
+		Sum.NumSticks += Frame.NumSticks;
+		Sum.NumUnsticks += Frame.NumUnsticks;
+		PeakTickMs = FMath::Max(PeakTickMs, Frame.WallRunTickMs);
+		PeakTraces = FMath::Max(PeakTraces, Frame.NumTraces);
+	}
+	const float GraphScaleMs = FMath::Max(PeakTickMs, 0.1f);
+
+	// background
+	FCanvasTileItem Background(Origin - FVector2D(5.f, 5.f), GraphSize + FVector2D(10.f, 95.f), FLinearColor(0.f, 0.f, 0.f, 0.5f));
+	Background.BlendMode = SE_BLEND_Translucent;
+	Canvas->DrawItem(Background);
+
+	// one bar per frame, all in a single triangle batch; bars are red on frames with stick/unstick
+	PerfGraphTris.Reset(NumFrames * 2);
+	const float BarWidth = GraphSize.X / FWallRunPerfCounters::HistorySize;
+	const float Bottom = Origin.Y + GraphSize.Y;
+	for (int32 Age = 0; Age < NumFrames; ++Age)
+	{
+		const FWallRunPerfFrame& Frame = FWallRunPerfCounters::GetFrame(Age);
+		const float Height = FMath::Min(Frame.WallRunTickMs / GraphScaleMs, 1.f) * GraphSize.Y;
+		if (Height <= 0.f)
+		{
+			continue;
+		}
+		const float Right = Origin.X + GraphSize.X - Age * BarWidth;
+		const FVector2D A(Right - BarWidth, Bottom);
+		const FVector2D B(Right, Bottom);
+		const FVector2D C(Right, Bottom - Height);
+		const FVector2D D(Right - BarWidth, Bottom - Height);
+		const FLinearColor Color = (Frame.NumSticks + Frame.NumUnsticks) > 0 ? FLinearColor::Red : FLinearColor::Green;
+
+		FCanvasUVTri& Tri0 = PerfGraphTris.AddDefaulted_GetRef();
+		Tri0.V0_Pos = A; Tri0.V1_Pos = B; Tri0.V2_Pos = C;
+		Tri0.V0_Color = Tri0.V1_Color = Tri0.V2_Color = Color;
+		FCanvasUVTri& Tri1 = PerfGraphTris.AddDefaulted_GetRef();
+		Tri1.V0_Pos = A; Tri1.V1_Pos = C; Tri1.V2_Pos = D;
+		Tri1.V0_Color = Tri1.V1_Color = Tri1.V2_Color = Color;
+	}
+	if (PerfGraphTris.Num() > 0)
+	{
+		FCanvasTriangleItem Graph(PerfGraphTris, GWhiteTexture);
+		Canvas->DrawItem(Graph);
+	}
+
+	const FWallRunPerfFrame& Last = FWallRunPerfCounters::GetFrame(0);
+	const float InvFrames = 1.f / NumFrames;
+	const FString Lines[] =
+	{
+		FString::Printf(TEXT("WallRun tick  %.3f ms  avg %.3f  peak %.3f  (graph scale)"), Last.WallRunTickMs, Sum.WallRunTickMs * InvFrames, PeakTickMs),
+		FString::Printf(TEXT("traces %d  avg %.1f  peak %d    hits %d  avg %.1f"), Last.NumTraces, Sum.NumTraces * InvFrames, PeakTraces, Last.NumHits, Sum.NumHits * InvFrames),
+		FString::Printf(TEXT("stick/unstick over %d frames  %d / %d    projectiles %d"), NumFrames, Sum.NumSticks, Sum.NumUnsticks, Last.NumProjectiles),
+		FString::Printf(TEXT("frame %.2f ms  avg %.2f%s"), Last.FrameTimeMs, Sum.FrameTimeMs * InvFrames, FWallRunPerfCounters::IsCapturing() ? TEXT("   [capturing]") : TEXT("")),
+	};
+	FCanvasTextItem Text(FVector2D::ZeroVector, FText::GetEmpty(), GEngine->GetTinyFont(), FLinearColor::White);
+	Text.EnableShadow(FLinearColor::Black);
+	for (int32 Line = 0; Line < UE_ARRAY_COUNT(Lines); ++Line)
+	{
+		Text.Position = FVector2D(Origin.X, Bottom + 5.f + Line * 20.f);
+		Text.Text = FText::FromString(Lines[Line]);
+		Canvas->DrawItem(Text);
+	}
+}
@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "Engine/Canvas.h"
 #include "WallRunHUD.generated.h"
 
+struct FStreamableHandle;
+
 UCLASS()
 class AWallRunHUD : public AHUD
 {
@@ -17,9 +20,22 @@ public:
 	/** Primary draw call for the HUD */
 	virtual void DrawHUD() override;
 
+protected:
+	virtual void BeginPlay() override;
+
+	/** Draws wallrun counters of recent frames (wallrun.PerfOverlay 1) */
+	void DrawPerfOverlay();
+
 private:
-	/** Crosshair asset pointer */
-	class UTexture2D* CrosshairTex;
+	/** Crosshair asset, loaded async in BeginPlay */
+	UPROPERTY()
+	TSoftObjectPtr<class UTexture2D> CrosshairTex;
+
+	/** Keeps crosshair loaded */
+	TSharedPtr<FStreamableHandle> CrosshairHandle;
+
+	/** Overlay graph geometry, reused between frames */
+	TArray<FCanvasUVTri> PerfGraphTris;
 
 };
 
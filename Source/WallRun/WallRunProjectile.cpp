@@ -1,11 +1,17 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WallRunProjectile.h"
+#include "WallRun.h"
+#include "WallRunPerfCounters.h"
+#include "WallRunProjectileSubsystem.h"
+#include "Engine/World.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 
 AWallRunProjectile::AWallRunProjectile() 
 {
+	LLM_SCOPE_BYTAG(WallRun_Projectiles);
+
 	// Use a sphere as a simple collision representation
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	CollisionComp->InitSphereRadius(5.0f);
@@ -29,6 +35,63 @@ AWallRunProjectile::AWallRunProjectile()
 
 	// Die after 3 seconds by default
 	InitialLifeSpan = 3.0f;
+
+	ShotSeed = 0;
+	bAuthoritative = true;
+	bLagCompensated = false;
+	ShotTime = 0.f;
+	ViewDelay = 0.f;
+	FlightTime = 0.f;
+	LastLocation = FVector::ZeroVector;
+
+	// ticks only on server with lag compensation, after movement
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+}
+
+void AWallRunProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// live count for performance overlay
+	++FWallRunPerfCounters::LiveProjectiles;
+
+	if (bLagCompensated)
+	{
+		// characters are hit in TraceRewound where the shooter saw them, not where they are now
+		CollisionComp->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+		LastLocation = GetActorLocation();
+		SetActorTickEnabled(true);
+	}
+}
+
+void AWallRunProjectile::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	FlightTime += DeltaSeconds;
+	TraceRewound();
+}
+
+bool AWallRunProjectile::TraceRewound()
+{
+	const FVector Start = LastLocation;
+	LastLocation = GetActorLocation();
+	UWallRunProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>();
+	return Projectiles && Projectiles->TraceRewound(this, Start, LastLocation);
+}
+
+void AWallRunProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	--FWallRunPerfCounters::LiveProjectiles;
+
+	if (UWallRunProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>())
+	{
+		Projectiles->OnProjectileEndPlay(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AWallRunProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
@@ -38,6 +101,38 @@ void AWallRunProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
 	{
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
 
+		if (bAuthoritative)
+		{
+			if (UWallRunProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UWallRunProjectileSubsystem>())
+			{
+				Projectiles->OnProjectileImpact(this, Hit);
+			}
+		}
 		Destroy();
 	}
+}
+
+void AWallRunProjectile::CatchUp(float Seconds, float Step)
+{
+	if (Seconds <= 0.f || Step <= 0.f)
+	{
+		return;
+	}
+	// sweeps and bounces as in regular ticks, hit may destroy projectile midway
+	float Remaining = Seconds;
+	while (Remaining > KINDA_SMALL_NUMBER && !IsPendingKill())
+	{
+		const float DeltaTime = FMath::Min(Remaining, Step);
+		ProjectileMovement->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+		Remaining -= DeltaTime;
+		FlightTime += DeltaTime;
+		if (bLagCompensated && !IsPendingKill() && TraceRewound())
+		{
+			return;
+		}
+	}
+	if (!IsPendingKill() && InitialLifeSpan > 0.f)
+	{
+		SetLifeSpan(FMath::Max(InitialLifeSpan - Seconds, KINDA_SMALL_NUMBER));
+	}
 }
\ No newline at end of file
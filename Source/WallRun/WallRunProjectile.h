@@ -25,13 +25,49 @@ class AWallRunProjectile : public AActor
 public:
 	AWallRunProjectile();
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
 	/** called when projectile hits something */
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	/** Advances movement by Seconds in Step slices, for shots spawned after they were fired */
+	void CatchUp(float Seconds, float Step);
+
+	/** Seed of the fire event this projectile was spawned from */
+	uint16 ShotSeed;
+
+	/** Spawned by server, its impacts correct client simulated copies */
+	bool bAuthoritative;
+
+	/** Hits characters as they were when the shooter saw them (lag compensation) instead of their current capsules */
+	bool bLagCompensated;
+
+	/** Server time the shot was fired at */
+	float ShotTime;
+
+	/** How far behind the server the shooter saw other characters (seconds) */
+	float ViewDelay;
+
+	/** Server time of characters as the shooter saw them while this projectile is where it is now */
+	float GetShooterViewTime() const { return ShotTime + FlightTime - ViewDelay; }
+
 	/** Returns CollisionComp subobject **/
 	USphereComponent* GetCollisionComp() const { return CollisionComp; }
 	/** Returns ProjectileMovement subobject **/
 	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+
+private:
+	/** Seconds simulated since the shot, including catch up */
+	float FlightTime;
+
+	FVector LastLocation;
+
+	/** Checks movement from LastLocation against rewound characters, true if one was hit (projectile is destroyed) */
+	bool TraceRewound();
 };
 
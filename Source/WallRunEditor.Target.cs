@@ -10,5 +10,6 @@ public class WallRunEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.Add("WallRun");
+		ExtraModuleNames.Add("WallRunInsights");
 	}
 }
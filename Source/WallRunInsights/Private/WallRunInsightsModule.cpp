@@ -0,0 +1,65 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "Features/IModularFeatures.h"
+#include "TraceServices/ModuleService.h"
+#include "TraceServices/Model/AnalysisSession.h"
+#include "WallRunTraceAnalyzer.h"
+#include "WallRunTraceProvider.h"
+#include "WallRunTimingViewExtender.h"
+
+// analysis side of WallRun trace channel (trace with -trace=cpu,wallrun)
+class FWallRunTraceModule : public Trace::IModule
+{
+public:
+	virtual void GetModuleInfo(Trace::FModuleInfo& OutModuleInfo) override
+	{
+		static const FName ModuleName("WallRunTrace");
+		OutModuleInfo.Name = ModuleName;
+		OutModuleInfo.DisplayName = TEXT("WallRun");
+	}
+
+	virtual void OnAnalysisBegin(Trace::IAnalysisSession& InSession) override
+	{
+		FWallRunTraceProvider* Provider = new FWallRunTraceProvider(InSession);
+		InSession.AddProvider(FWallRunTraceProvider::ProviderName, Provider);
+		InSession.AddAnalyzer(new FWallRunTraceAnalyzer(InSession, *Provider));
+	}
+
+	virtual void GetLoggers(TArray<const TCHAR*>& OutLoggers) override
+	{
+		OutLoggers.Add(TEXT("WallRun"));
+	}
+
+	virtual void GenerateReports(const Trace::IAnalysisSession& Session, const TCHAR* CmdLine, const TCHAR* OutputDirectory) override {}
+
+	virtual const TCHAR* GetCommandLineArgument() override
+	{
+		return TEXT("wallruntrace");
+	}
+};
+
+class FWallRunInsightsModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override
+	{
+		IModularFeatures::Get().RegisterModularFeature(Trace::ModuleFeatureName, &TraceModule);
+		IModularFeatures::Get().RegisterModularFeature(Insights::TimingViewExtenderFeatureName, &TimingViewExtender);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		IModularFeatures::Get().UnregisterModularFeature(Insights::TimingViewExtenderFeatureName, &TimingViewExtender);
+		IModularFeatures::Get().UnregisterModularFeature(Trace::ModuleFeatureName, &TraceModule);
+	}
+
+private:
+	FWallRunTraceModule TraceModule;
+	FWallRunTimingViewExtender TimingViewExtender;
+};
+
+IMPLEMENT_MODULE(FWallRunInsightsModule, WallRunInsights);
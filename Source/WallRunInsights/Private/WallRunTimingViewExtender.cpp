@@ -0,0 +1,175 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunTimingViewExtender.h"
+#include "WallRunTraceProvider.h"
+#include "Insights/ITimingViewSession.h"
+#include "Insights/ViewModels/TimingEventsTrack.h"
+#include "Insights/ViewModels/ITimingViewDrawHelper.h"
+#include "Insights/ViewModels/TimingTrackViewport.h"
+#include "Insights/ViewModels/TooltipDrawState.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+#define LOCTEXT_NAMESPACE "WallRunTimingViewExtender"
+
+// wall spans (stick -> unstick, named by unstick reason) at depth 0, instant events at depth 1
+class FWallRunTimingTrack : public FTimingEventsTrack
+{
+	INSIGHTS_DECLARE_RTTI(FWallRunTimingTrack, FTimingEventsTrack)
+
+public:
+	FWallRunTimingTrack(const Trace::IAnalysisSession& InAnalysisSession, uint32 InCharacterId, const FString& InName)
+		: FTimingEventsTrack(InName)
+		, AnalysisSession(InAnalysisSession)
+		, CharacterId(InCharacterId)
+	{
+	}
+
+	virtual void BuildDrawState(ITimingEventsTrackDrawStateBuilder& Builder, const ITimingTrackUpdateContext& Context) override
+	{
+		const FTimingTrackViewport& Viewport = Context.GetViewport();
+		ForEachEvent(Viewport.GetStartTime(), Viewport.GetEndTime(), [&Builder](double StartTime, double EndTime, uint32 Depth, const TCHAR* Name, uint8 Type)
+		{
+			Builder.AddEvent(StartTime, EndTime, Depth, Name, Type);
+		});
+	}
+
+	virtual void InitTooltip(FTooltipDrawState& InOutTooltip, const ITimingEvent& InTooltipEvent) const override
+	{
+		if (!InTooltipEvent.CheckTrack(this) || !InTooltipEvent.Is<FTimingEvent>())
+		{
+			return;
+		}
+		const FTimingEvent& TooltipEvent = InTooltipEvent.As<FTimingEvent>();
+
+		InOutTooltip.ResetContent();
+		FindEvent(TooltipEvent.GetStartTime(), TooltipEvent.GetDepth(), [&InOutTooltip, &TooltipEvent](const FWallRunTraceEvent& Event)
+		{
+			InOutTooltip.AddTitle(WallRunTraceNames::GetEventTypeName(Event.Type));
+			if (TooltipEvent.GetDepth() == 0)
+			{
+				InOutTooltip.AddNameValueTextLine(TEXT("Duration:"), FString::Printf(TEXT("%.3f s"), TooltipEvent.GetDuration()));
+			}
+			InOutTooltip.AddNameValueTextLine(TEXT("Reason:"), WallRunTraceNames::GetReasonName(Event.Reason));
+			InOutTooltip.AddNameValueTextLine(TEXT("Normal:"), Event.Normal.ToString());
+			InOutTooltip.AddNameValueTextLine(TEXT("Velocity:"), FString::Printf(TEXT("%s (%.0f)"), *Event.Velocity.ToString(), Event.Velocity.Size()));
+			InOutTooltip.AddNameValueTextLine(TEXT("Location:"), Event.Location.ToString());
+		});
+		InOutTooltip.UpdateLayout();
+	}
+
+private:
+	template <typename CallbackType>
+	void ForEachEvent(double StartTime, double EndTime, CallbackType Callback) const
+	{
+		Trace::FAnalysisSessionReadScope SessionReadScope(AnalysisSession);
+		const FWallRunTraceProvider* Provider = AnalysisSession.ReadProvider<FWallRunTraceProvider>(FWallRunTraceProvider::ProviderName);
+		const FWallRunTraceCharacter* Character = Provider ? Provider->FindCharacter(CharacterId) : nullptr;
+		if (!Character)
+		{
+			return;
+		}
+
+		// events are few (a handful per second per character), linear walk is fine
+		double StickTime = -1.0;
+		for (const FWallRunTraceEvent& Event : Character->Events)
+		{
+			if (Event.Type == WallRunTraceNames::Stick)
+			{
+				StickTime = Event.Time;
+			}
+			else if (Event.Type == WallRunTraceNames::Unstick)
+			{
+				if (StickTime >= 0.0 && Event.Time >= StartTime && StickTime <= EndTime)
+				{
+					Callback(StickTime, Event.Time, 0, WallRunTraceNames::GetReasonName(Event.Reason), Event.Type);
+				}
+				StickTime = -1.0;
+			}
+			else if (Event.Time >= StartTime && Event.Time <= EndTime)
+			{
+				Callback(Event.Time, Event.Time, 1, WallRunTraceNames::GetEventTypeName(Event.Type), Event.Type);
+			}
+		}
+		// still on the wall at the end of the trace
+		if (StickTime >= 0.0 && StickTime <= EndTime)
+		{
+			Callback(StickTime, FMath::Max(AnalysisSession.GetDurationSeconds(), StickTime), 0, TEXT("WallRun"), WallRunTraceNames::Unstick);
+		}
+	}
+
+	// wall spans are looked up by their stick event, instant events by themselves
+	template <typename CallbackType>
+	void FindEvent(double Time, uint32 Depth, CallbackType Callback) const
+	{
+		Trace::FAnalysisSessionReadScope SessionReadScope(AnalysisSession);
+		const FWallRunTraceProvider* Provider = AnalysisSession.ReadProvider<FWallRunTraceProvider>(FWallRunTraceProvider::ProviderName);
+		const FWallRunTraceCharacter* Character = Provider ? Provider->FindCharacter(CharacterId) : nullptr;
+		if (!Character)
+		{
+			return;
+		}
+
+		for (int32 i = 0; i < Character->Events.Num(); ++i)
+		{
+			const FWallRunTraceEvent& Event = Character->Events[i];
+			if (Event.Time != Time)
+			{
+				continue;
+			}
+			if (Depth == 0 && Event.Type == WallRunTraceNames::Stick)
+			{
+				// show the unstick that ended the span, it has the reason
+				const bool bHasUnstick = Character->Events.IsValidIndex(i + 1) && Character->Events[i + 1].Type == WallRunTraceNames::Unstick;
+				Callback(bHasUnstick ? Character->Events[i + 1] : Event);
+				return;
+			}
+			if (Depth == 1 && Event.Type != WallRunTraceNames::Stick && Event.Type != WallRunTraceNames::Unstick)
+			{
+				Callback(Event);
+				return;
+			}
+		}
+	}
+
+	const Trace::IAnalysisSession& AnalysisSession;
+	uint32 CharacterId;
+};
+
+INSIGHTS_IMPLEMENT_RTTI(FWallRunTimingTrack)
+
+
+void FWallRunTimingViewExtender::OnBeginSession(Insights::ITimingViewSession& InSession)
+{
+	Tracks.Reset();
+}
+
+void FWallRunTimingViewExtender::OnEndSession(Insights::ITimingViewSession& InSession)
+{
+	Tracks.Reset();
+}
+
+void FWallRunTimingViewExtender::Tick(Insights::ITimingViewSession& InSession, const Trace::IAnalysisSession& InAnalysisSession)
+{
+	Trace::FAnalysisSessionReadScope SessionReadScope(InAnalysisSession);
+	const FWallRunTraceProvider* Provider = InAnalysisSession.ReadProvider<FWallRunTraceProvider>(FWallRunTraceProvider::ProviderName);
+	if (!Provider || Provider->GetNumCharacters() == Tracks.Num())
+	{
+		return;
+	}
+
+	// characters show up while live trace is being analyzed
+	Provider->EnumerateCharacters([this, &InSession, &InAnalysisSession](const FWallRunTraceCharacter& Character)
+	{
+		if (!Tracks.Contains(Character.Id))
+		{
+			TSharedPtr<FWallRunTimingTrack> Track = MakeShared<FWallRunTimingTrack>(InAnalysisSession, Character.Id, FString::Printf(TEXT("WallRun - %s"), *Character.Name));
+			Track->SetVisibilityFlag(true);
+			InSession.AddScrollableTrack(Track);
+			Tracks.Add(Character.Id, Track);
+		}
+	});
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,22 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Insights/ITimingViewExtender.h"
+
+class FWallRunTimingTrack;
+
+// adds one timeline track per traced character to Timing Insights
+class FWallRunTimingViewExtender : public Insights::ITimingViewExtender
+{
+public:
+	virtual void OnBeginSession(Insights::ITimingViewSession& InSession) override;
+	virtual void OnEndSession(Insights::ITimingViewSession& InSession) override;
+	virtual void Tick(Insights::ITimingViewSession& InSession, const Trace::IAnalysisSession& InAnalysisSession) override;
+	virtual void ExtendFilterMenu(Insights::ITimingViewSession& InSession, FMenuBuilder& InMenuBuilder) override {}
+
+private:
+	TMap<uint32, TSharedPtr<FWallRunTimingTrack>> Tracks;
+};
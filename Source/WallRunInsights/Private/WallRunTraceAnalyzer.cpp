@@ -0,0 +1,51 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunTraceAnalyzer.h"
+#include "WallRunTraceProvider.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+FWallRunTraceAnalyzer::FWallRunTraceAnalyzer(Trace::IAnalysisSession& InSession, FWallRunTraceProvider& InProvider)
+	: Session(InSession)
+	, Provider(InProvider)
+{
+}
+
+void FWallRunTraceAnalyzer::OnAnalysisBegin(const FOnAnalysisContext& Context)
+{
+	FInterfaceBuilder& Builder = Context.InterfaceBuilder;
+	Builder.RouteEvent(RouteId_CharacterName, "WallRun", "CharacterName");
+	Builder.RouteEvent(RouteId_StateChange, "WallRun", "StateChange");
+}
+
+bool FWallRunTraceAnalyzer::OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context)
+{
+	Trace::FAnalysisSessionEditScope _(Session);
+
+	const FEventData& EventData = Context.EventData;
+	switch (RouteId)
+	{
+	case RouteId_CharacterName:
+	{
+		const TCHAR* Name = reinterpret_cast<const TCHAR*>(EventData.GetAttachment());
+		Provider.SetCharacterName(EventData.GetValue<uint32>("CharacterId"), Name);
+		break;
+	}
+	case RouteId_StateChange:
+	{
+		FWallRunTraceEvent Event;
+		// same clock as cpu timing events, so timelines line up with cpu tracks
+		Event.Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+		Event.Type = EventData.GetValue<uint8>("Type");
+		Event.Reason = EventData.GetValue<uint8>("Reason");
+		Event.Normal = FVector(EventData.GetValue<float>("NormalX"), EventData.GetValue<float>("NormalY"), EventData.GetValue<float>("NormalZ"));
+		Event.Velocity = FVector(EventData.GetValue<float>("VelocityX"), EventData.GetValue<float>("VelocityY"), EventData.GetValue<float>("VelocityZ"));
+		Event.Location = FVector(EventData.GetValue<float>("LocationX"), EventData.GetValue<float>("LocationY"), EventData.GetValue<float>("LocationZ"));
+		Provider.AddEvent(EventData.GetValue<uint32>("CharacterId"), Event);
+		Session.UpdateDurationSeconds(Event.Time);
+		break;
+	}
+	}
+	return true;
+}
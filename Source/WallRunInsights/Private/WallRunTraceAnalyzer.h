@@ -0,0 +1,31 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Analyzer.h"
+
+class FWallRunTraceProvider;
+namespace Trace { class IAnalysisSession; }
+
+// reads WallRun.CharacterName and WallRun.StateChange events (WallRunTrace.cpp in WallRun module) into the provider
+class FWallRunTraceAnalyzer : public Trace::IAnalyzer
+{
+public:
+	FWallRunTraceAnalyzer(Trace::IAnalysisSession& InSession, FWallRunTraceProvider& InProvider);
+
+	virtual void OnAnalysisBegin(const FOnAnalysisContext& Context) override;
+	virtual void OnAnalysisEnd() override {}
+	virtual bool OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context) override;
+
+private:
+	enum : uint16
+	{
+		RouteId_CharacterName,
+		RouteId_StateChange,
+	};
+
+	Trace::IAnalysisSession& Session;
+	FWallRunTraceProvider& Provider;
+};
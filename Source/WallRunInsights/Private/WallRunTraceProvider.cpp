@@ -0,0 +1,65 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+
+#include "WallRunTraceProvider.h"
+
+FName FWallRunTraceProvider::ProviderName("WallRunTraceProvider");
+
+const TCHAR* WallRunTraceNames::GetEventTypeName(uint8 Type)
+{
+	static const TCHAR* Names[] = { TEXT("Stick"), TEXT("Unstick"), TEXT("Jump"), TEXT("Climb"), TEXT("Land"), TEXT("ClimbFail") };
+	return Type < UE_ARRAY_COUNT(Names) ? Names[Type] : TEXT("Unknown");
+}
+
+const TCHAR* WallRunTraceNames::GetReasonName(uint8 Reason)
+{
+	static const TCHAR* Names[] = { TEXT("Other"), TEXT("Timeout"), TEXT("Deviation"), TEXT("WallEnd"), TEXT("Crouch"), TEXT("Jump"), TEXT("Climb"), TEXT("Land") };
+	return Reason < UE_ARRAY_COUNT(Names) ? Names[Reason] : TEXT("Unknown");
+}
+
+FWallRunTraceProvider::FWallRunTraceProvider(Trace::IAnalysisSession& InSession)
+	: Session(InSession)
+{
+}
+
+FWallRunTraceCharacter& FWallRunTraceProvider::FindOrAddCharacter(uint32 CharacterId)
+{
+	if (const int32* Index = CharacterIndices.Find(CharacterId))
+	{
+		return Characters[*Index];
+	}
+	CharacterIndices.Add(CharacterId, Characters.Num());
+	FWallRunTraceCharacter& Character = Characters.AddDefaulted_GetRef();
+	Character.Id = CharacterId;
+	Character.Name = FString::Printf(TEXT("Character %u"), CharacterId);
+	return Character;
+}
+
+void FWallRunTraceProvider::AddEvent(uint32 CharacterId, const FWallRunTraceEvent& Event)
+{
+	Session.WriteAccessCheck();
+	FindOrAddCharacter(CharacterId).Events.Add(Event);
+}
+
+void FWallRunTraceProvider::SetCharacterName(uint32 CharacterId, const TCHAR* Name)
+{
+	Session.WriteAccessCheck();
+	FindOrAddCharacter(CharacterId).Name = Name;
+}
+
+void FWallRunTraceProvider::EnumerateCharacters(TFunctionRef<void(const FWallRunTraceCharacter& Character)> Callback) const
+{
+	Session.ReadAccessCheck();
+	for (const FWallRunTraceCharacter& Character : Characters)
+	{
+		Callback(Character);
+	}
+}
+
+const FWallRunTraceCharacter* FWallRunTraceProvider::FindCharacter(uint32 CharacterId) const
+{
+	Session.ReadAccessCheck();
+	const int32* Index = CharacterIndices.Find(CharacterId);
+	return Index ? &Characters[*Index] : nullptr;
+}
@@ -0,0 +1,60 @@
+// titanfall-like mechanics for wall traversal
+// made by Ivan Feklistov i.a.feklistov@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+// values of EWallRunEventType / EWallRunOffWallReason in WallRun module (not linked, see Build.cs)
+namespace WallRunTraceNames
+{
+	const TCHAR* GetEventTypeName(uint8 Type);
+	const TCHAR* GetReasonName(uint8 Reason);
+
+	constexpr uint8 Stick = 0;
+	constexpr uint8 Unstick = 1;
+}
+
+struct FWallRunTraceEvent
+{
+	double Time = 0.0;
+	uint8 Type = 0;
+	uint8 Reason = 0;
+	FVector Normal = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FVector Location = FVector::ZeroVector;
+};
+
+struct FWallRunTraceCharacter
+{
+	uint32 Id = 0;
+	FString Name;
+	// in time order
+	TArray<FWallRunTraceEvent> Events;
+};
+
+// wallrun state changes of a trace session, grouped by character
+class FWallRunTraceProvider : public Trace::IProvider
+{
+public:
+	static FName ProviderName;
+
+	explicit FWallRunTraceProvider(Trace::IAnalysisSession& InSession);
+
+	// analysis thread, inside session edit scope
+	void AddEvent(uint32 CharacterId, const FWallRunTraceEvent& Event);
+	void SetCharacterName(uint32 CharacterId, const TCHAR* Name);
+
+	// inside session read scope
+	int32 GetNumCharacters() const { return Characters.Num(); }
+	void EnumerateCharacters(TFunctionRef<void(const FWallRunTraceCharacter& Character)> Callback) const;
+	const FWallRunTraceCharacter* FindCharacter(uint32 CharacterId) const;
+
+private:
+	FWallRunTraceCharacter& FindOrAddCharacter(uint32 CharacterId);
+
+	Trace::IAnalysisSession& Session;
+	TArray<FWallRunTraceCharacter> Characters;
+	TMap<uint32, int32> CharacterIndices;
+};
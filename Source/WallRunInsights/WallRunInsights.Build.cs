@@ -0,0 +1,14 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class WallRunInsights : ModuleRules
+{
+	public WallRunInsights(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// no dependency on WallRun module, so analyzer can be moved to a plugin loaded by standalone UnrealInsights
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Slate", "SlateCore", "TraceAnalysis", "TraceServices", "TraceInsights" });
+	}
+}